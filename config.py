@@ -10,5 +10,9 @@ def get_doc_path():
 def get_doc_classes():
     return [
         "Slicer",
-        "SlicedMesh"
+        "SlicedMesh",
+        "SlicedArrays",
+        "SliceSession",
+        "SliceJob",
+        "SliceScheduler"
     ]
@@ -1,12 +1,49 @@
 #include "register_types.h"
 
 #include "core/class_db.h"
+#include "core/os/os.h"
+#include "core/project_settings.h"
 #include "slicer.h"
+#include "slice_scheduler.h"
+#include "utils/worker_pool.h"
+#include "utils/slice_profiler.h"
+
+static SliceProfiler *slice_profiler = NULL;
+
+/**
+ * How many threads the shared WorkerPool gets. It's only started the first time something
+ * hands work over, so this is read then rather than when the module is registered
+*/
+static int get_worker_thread_count() {
+    // Zero leaves a thread for every core but the one the work is handed over from
+    int thread_count = GLOBAL_GET("slicer/worker_pool/thread_count");
+    if (thread_count <= 0) {
+        thread_count = OS::get_singleton()->get_processor_count() - 1;
+    }
+    return thread_count;
+}
 
 void register_slicer_types() {
     ClassDB::register_class<Slicer>();
     ClassDB::register_class<SlicedMesh>();
+    ClassDB::register_class<SlicedArrays>();
+    ClassDB::register_class<SliceSession>();
+    ClassDB::register_class<SliceJob>();
+    ClassDB::register_class<SliceScheduler>();
+
+    GLOBAL_DEF("slicer/worker_pool/thread_count", 0);
+    WorkerPool::set_lazy_singleton(get_worker_thread_count);
+
+    slice_profiler = memnew(SliceProfiler);
+    SliceProfiler::set_singleton(slice_profiler);
 }
 
 void unregister_slicer_types() {
+    WorkerPool::free_lazy_singleton();
+
+    SliceProfiler::set_singleton(NULL);
+    if (slice_profiler) {
+        memdelete(slice_profiler);
+        slice_profiler = NULL;
+    }
 }
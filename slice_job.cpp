@@ -0,0 +1,195 @@
+#include "slice_job.h"
+#include "core/os/os.h"
+#include "utils/surface_filler.h"
+#include "utils/triangulator.h"
+
+// How many faces get split between each check of the clock. Reading the time isn't free,
+// so this trades a little overshoot of the budget for not checking after every face
+static const int FACES_PER_CHECK = 64;
+
+void SliceJob::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("step", "budget_usec"), &SliceJob::step);
+    ClassDB::bind_method(D_METHOD("is_done"), &SliceJob::is_done);
+    ClassDB::bind_method(D_METHOD("get_result"), &SliceJob::get_result);
+}
+
+SliceJob::SliceJob(const Ref<Mesh> &p_mesh, const Plane &p_plane, const Vector<Intersector::SplitResult> &p_split_results, const Vector<Vector<SlicerFace> > &p_cached_faces, const Ref<Material> &p_cross_section_material, uint32_t p_cross_section_compression, const Rect2 &p_cross_section_uv_rect, bool p_merge_cross_section) {
+    stage = STAGE_SPLIT;
+    mesh = p_mesh;
+    split_results = p_split_results;
+    cached_faces = p_cached_faces;
+    cross_section_material = p_cross_section_material;
+    cross_section_compression = p_cross_section_compression;
+    cross_section_uv_rect = p_cross_section_uv_rect;
+    merge_cross_section = p_merge_cross_section;
+    keep_upper = split_results.size() == 0 || split_results[0].keep_upper;
+    keep_lower = split_results.size() == 0 || split_results[0].keep_lower;
+
+    surface_cursor = 0;
+    face_cursor = 0;
+    has_surface_faces = false;
+    cross_section = NULL;
+    pack_cursor = 0;
+
+    // Same snapping as Slicer::slice_by_plane
+    is_axis_aligned = Intersector::AxisPlane::from_plane(p_plane, axis_plane);
+    plane = is_axis_aligned ? axis_plane.to_plane() : p_plane;
+}
+
+bool SliceJob::split_surfaces(uint64_t deadline) {
+    OS *os = OS::get_singleton();
+
+    while (surface_cursor < split_results.size()) {
+        if (!has_surface_faces) {
+            surface_faces = cached_faces.size() > 0 ? cached_faces[surface_cursor] : SlicerFace::faces_from_surface(**mesh, surface_cursor);
+            has_surface_faces = true;
+
+            if (os->get_ticks_usec() >= deadline) {
+                return false;
+            }
+        }
+
+        Intersector::SplitResult *split_results_writer = split_results.ptrw();
+        Intersector::SplitResult &results = split_results_writer[surface_cursor];
+        const SlicerFace *faces_reader = surface_faces.ptr();
+        int face_count = surface_faces.size();
+
+        while (face_cursor < face_count) {
+            int chunk_end = MIN(face_cursor + FACES_PER_CHECK, face_count);
+            if (is_axis_aligned) {
+                for (; face_cursor < chunk_end; face_cursor++) {
+                    Intersector::split_face_by_plane(axis_plane, faces_reader[face_cursor], results);
+                }
+            } else {
+                for (; face_cursor < chunk_end; face_cursor++) {
+                    Intersector::split_face_by_plane(plane, faces_reader[face_cursor], results);
+                }
+            }
+
+            if (face_cursor < face_count && os->get_ticks_usec() >= deadline) {
+                return false;
+            }
+        }
+
+        intersection_points.append_array(results.intersection_points);
+        results.intersection_points.resize(0);
+
+        surface_faces = Vector<SlicerFace>();
+        has_surface_faces = false;
+        face_cursor = 0;
+        surface_cursor++;
+
+        if (surface_cursor < split_results.size() && os->get_ticks_usec() >= deadline) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SliceJob::pack_halves(uint64_t deadline) {
+    int surface_count = split_results.size();
+    bool keep_halves[2] = { keep_upper, keep_lower };
+
+    while (pack_cursor < surface_count * 2) {
+        int half = pack_cursor / surface_count;
+        int surface_idx = pack_cursor % surface_count;
+        pack_cursor++;
+
+        if (!keep_halves[half]) {
+            continue;
+        }
+
+        bool is_merge_target = surface_idx == halves[half].merge_target;
+        halves[half].surfaces.ptrw()[surface_idx] = pack_half_surface(split_results[surface_idx], is_merge_target ? cross_section_faces : Vector<SlicerFace>(), half == 0);
+
+        if (pack_cursor < surface_count * 2 && OS::get_singleton()->get_ticks_usec() >= deadline) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SliceJob::clear_packed() {
+    for (int i = 0; i < 2; i++) {
+        halves[i].clear();
+    }
+
+    if (cross_section) {
+        memdelete(cross_section);
+        cross_section = NULL;
+    }
+}
+
+bool SliceJob::step(int budget_usec) {
+    uint64_t deadline = OS::get_singleton()->get_ticks_usec() + MAX(budget_usec, 0);
+
+    while (stage != STAGE_DONE) {
+        switch (stage) {
+            case STAGE_SPLIT: {
+                if (!split_surfaces(deadline)) {
+                    return false;
+                }
+
+                mesh = Ref<Mesh>();
+                cached_faces = Vector<Vector<SlicerFace> >();
+
+                // Same as slice_by_plane, a plane that misses the mesh gives a null result
+                stage = intersection_points.size() > 0 ? STAGE_CROSS_SECTION : STAGE_DONE;
+            } break;
+            case STAGE_CROSS_SECTION: {
+                cross_section_faces = Triangulator::monotone_chain(intersection_points, plane.normal, cross_section_uv_rect);
+                intersection_points = Vector<Vector3>();
+                cross_section = pack_cross_section(cross_section_faces, cross_section_compression);
+
+                bool keep_halves[2] = { keep_upper, keep_lower };
+                for (int i = 0; i < 2; i++) {
+                    if (!keep_halves[i]) {
+                        continue;
+                    }
+
+                    halves[i].surfaces.resize(split_results.size());
+                    for (int j = 0; j < split_results.size(); j++) {
+                        halves[i].surfaces.ptrw()[j] = NULL;
+                    }
+
+                    if (merge_cross_section && cross_section) {
+                        halves[i].merge_target = find_merge_target(split_results, cross_section_material, i == 0);
+                    }
+                }
+
+                stage = STAGE_PACK;
+            } break;
+            case STAGE_PACK: {
+                if (!pack_halves(deadline)) {
+                    return false;
+                }
+
+                stage = STAGE_WRITE;
+            } break;
+            case STAGE_WRITE: {
+                result = Ref<SlicedMesh>(memnew(SlicedMesh));
+                result->write_halves(split_results, halves, cross_section, cross_section_material, keep_upper, keep_lower, NULL, Ref<ArrayMesh>());
+
+                // Nothing else needs these now
+                clear_packed();
+                split_results = Vector<Intersector::SplitResult>();
+                cross_section_faces = Vector<SlicerFace>();
+                stage = STAGE_DONE;
+            } break;
+            case STAGE_DONE:
+                break;
+        }
+
+        if (stage != STAGE_DONE && OS::get_singleton()->get_ticks_usec() >= deadline) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+SliceJob::~SliceJob() {
+    clear_packed();
+}
@@ -0,0 +1,139 @@
+#ifndef SLICE_JOB_H
+#define SLICE_JOB_H
+
+#include "core/reference.h"
+#include "sliced_mesh.h"
+
+/**
+ * A cut that's made a little at a time rather than all at once, for meshes that are
+ * too large to cut within a single frame. Each call to step works through as much of
+ * the cut as it can in the time it's given and then hands control back, picking up
+ * where it left off on the next call. Once everything has been cut the result is the
+ * same SlicedMesh slice_by_plane would have returned.
+ *
+ * Faces are split a chunk at a time and each surface of each half is packed on its own,
+ * with everything done so far kept between calls. A few steps can't be broken up any
+ * further though: reading a single surface's faces out of the mesh (which is skipped
+ * when the Slicer has them cached already), triangulating the cross section, and writing
+ * the packed halves into their meshes at the end.
+ *
+ * Everything runs on the calling thread, so this is meant for when spreading the work
+ * over frames is preferable to (or more practical than) handing it to another thread.
+ * The mesh shouldn't be changed while the job is running
+*/
+class SliceJob : public Reference {
+    GDCLASS(SliceJob, Reference);
+
+    enum Stage {
+        // Going through the mesh's surfaces, breaking them down into faces and splitting them
+        STAGE_SPLIT,
+        // Triangulating the cross section out of every point the plane crossed the mesh at
+        STAGE_CROSS_SECTION,
+        // Packing each surface of each half into a vertex buffer
+        STAGE_PACK,
+        // Writing the packed halves into meshes
+        STAGE_WRITE,
+        STAGE_DONE,
+    };
+
+    Stage stage;
+
+    Ref<Mesh> mesh;
+    Plane plane;
+    bool is_axis_aligned;
+    Intersector::AxisPlane axis_plane;
+
+    Ref<Material> cross_section_material;
+    uint32_t cross_section_compression;
+    Rect2 cross_section_uv_rect;
+    bool merge_cross_section;
+    bool keep_upper;
+    bool keep_lower;
+
+    // One result for each surface, with its material, compression and keep flags filled in up front
+    Vector<Intersector::SplitResult> split_results;
+
+    // Each surface's faces, if the Slicer already had them cached. Otherwise
+    // they're read out of the mesh as each surface comes up
+    Vector<Vector<SlicerFace> > cached_faces;
+
+    // The surface being split, and how far through its faces we've gotten
+    int surface_cursor;
+    int face_cursor;
+    bool has_surface_faces;
+    Vector<SlicerFace> surface_faces;
+
+    Vector<Vector3> intersection_points;
+    Vector<SlicerFace> cross_section_faces;
+    SurfaceFiller *cross_section;
+
+    // Upper then lower, and the next surface of them to pack, counting through
+    // the upper half's surfaces and then the lower's
+    PackedHalf halves[2];
+    int pack_cursor;
+
+    Ref<SlicedMesh> result;
+
+    /**
+     * Splits faces until either every surface has been split (returning true) or the deadline
+     * (in OS::get_ticks_usec time) has passed
+    */
+    bool split_surfaces(uint64_t deadline);
+
+    /**
+     * Like split_surfaces, but packs one surface of one half at a time
+    */
+    bool pack_halves(uint64_t deadline);
+
+    /**
+     * Frees whatever was packed but hasn't been written out
+    */
+    void clear_packed();
+
+protected:
+    static void _bind_methods();
+
+public:
+    /**
+     * Carries on with the cut for up to roughly budget_usec microseconds. At least a little
+     * progress is made on every call, however small the budget. Returns true once the job
+     * is done
+    */
+    bool step(int budget_usec);
+
+    bool is_done() const {
+        return stage == STAGE_DONE;
+    }
+
+    /**
+     * The finished cut, or null if the job isn't done yet or the plane didn't cut the mesh
+    */
+    Ref<SlicedMesh> get_result() const {
+        return result;
+    }
+
+    /**
+     * Sets up a cut of the mesh. split_results should have an entry for each of the mesh's surfaces,
+     * describing how the faces split out of it should be kept and packed. p_cached_faces can either
+     * be empty or hold the faces of every surface, if they've already been read out of the mesh
+    */
+    SliceJob(const Ref<Mesh> &p_mesh, const Plane &p_plane, const Vector<Intersector::SplitResult> &p_split_results, const Vector<Vector<SlicerFace> > &p_cached_faces, const Ref<Material> &p_cross_section_material, uint32_t p_cross_section_compression, const Rect2 &p_cross_section_uv_rect, bool p_merge_cross_section);
+
+    SliceJob() {
+        stage = STAGE_DONE;
+        is_axis_aligned = false;
+        cross_section_compression = Mesh::ARRAY_COMPRESS_DEFAULT;
+        merge_cross_section = false;
+        keep_upper = true;
+        keep_lower = true;
+        surface_cursor = 0;
+        face_cursor = 0;
+        has_surface_faces = false;
+        cross_section = NULL;
+        pack_cursor = 0;
+    }
+
+    ~SliceJob();
+};
+
+#endif // SLICE_JOB_H
@@ -0,0 +1,174 @@
+#include "slice_scheduler.h"
+#include "core/os/os.h"
+#include "scene/3d/camera.h"
+#include "scene/main/viewport.h"
+
+/**
+ * How many faces cutting the mesh will have to look at
+*/
+int count_faces(const Ref<Mesh> &mesh) {
+    int count = 0;
+    for (int i = 0; i < mesh->get_surface_count(); i++) {
+        int index_count = mesh->surface_get_array_index_len(i);
+        count += (index_count > 0 ? index_count : mesh->surface_get_array_len(i)) / 3;
+    }
+    return count;
+}
+
+void SliceScheduler::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("queue_slice", "instance", "plane", "cross_section_material", "critical"), &SliceScheduler::queue_slice, Variant::NIL, false);
+    ClassDB::bind_method(D_METHOD("cancel", "instance"), &SliceScheduler::cancel);
+    ClassDB::bind_method(D_METHOD("flush"), &SliceScheduler::flush);
+    ClassDB::bind_method(D_METHOD("get_pending_count"), &SliceScheduler::get_pending_count);
+
+    ClassDB::bind_method(D_METHOD("set_slicer_path", "slicer_path"), &SliceScheduler::set_slicer_path);
+    ClassDB::bind_method(D_METHOD("get_slicer_path"), &SliceScheduler::get_slicer_path);
+    ClassDB::bind_method(D_METHOD("set_budget_usec", "budget_usec"), &SliceScheduler::set_budget_usec);
+    ClassDB::bind_method(D_METHOD("get_budget_usec"), &SliceScheduler::get_budget_usec);
+    ClassDB::bind_method(D_METHOD("set_budget_faces", "budget_faces"), &SliceScheduler::set_budget_faces);
+    ClassDB::bind_method(D_METHOD("get_budget_faces"), &SliceScheduler::get_budget_faces);
+
+    ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "slicer_path", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "Slicer"), "set_slicer_path", "get_slicer_path");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "budget_usec"), "set_budget_usec", "get_budget_usec");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "budget_faces"), "set_budget_faces", "get_budget_faces");
+
+    ADD_SIGNAL(MethodInfo("slice_completed", PropertyInfo(Variant::OBJECT, "instance", PROPERTY_HINT_RESOURCE_TYPE, "MeshInstance"), PropertyInfo(Variant::OBJECT, "sliced_mesh", PROPERTY_HINT_RESOURCE_TYPE, "SlicedMesh")));
+}
+
+void SliceScheduler::_notification(int p_what) {
+    if (p_what == NOTIFICATION_PROCESS) {
+        process_queue(false);
+    }
+}
+
+void SliceScheduler::queue_slice(Node *instance, const Plane plane, const Ref<Material> cross_section_material, bool critical) {
+    MeshInstance *mesh_instance = Object::cast_to<MeshInstance>(instance);
+    ERR_FAIL_COND_MSG(!mesh_instance, "Only MeshInstances can be sliced.");
+
+    ERR_FAIL_COND_MSG(plane.normal == Vector3(), "The plane needs a normal.");
+
+    if (mesh_instance->get_mesh().is_null()) {
+        return;
+    }
+
+    // The cut is made through normal * d, which is only a point on the
+    // plane if the normal is a unit vector
+    Request request;
+    request.instance_id = mesh_instance->get_instance_id();
+    request.plane = plane.normalized();
+    request.cross_section_material = cross_section_material;
+    request.critical = critical;
+    request.sequence = next_sequence++;
+    request.face_count = count_faces(mesh_instance->get_mesh());
+    request.on_screen = false;
+    request.distance = 0;
+
+    add_request(request, true);
+    set_process(true);
+}
+
+void SliceScheduler::cancel(Node *instance) {
+    ERR_FAIL_NULL(instance);
+
+    for (int i = 0; i < pending.size(); i++) {
+        if (pending[i].instance_id == instance->get_instance_id()) {
+            pending.remove(i);
+            return;
+        }
+    }
+}
+
+void SliceScheduler::add_request(const Request &request, bool is_newer) {
+    for (int i = 0; i < pending.size(); i++) {
+        Request &existing = pending.ptrw()[i];
+        if (existing.instance_id != request.instance_id) {
+            continue;
+        }
+
+        // Whichever cut was asked for last wins, but it keeps the
+        // place in line of whichever was asked for first
+        if (is_newer) {
+            existing.plane = request.plane;
+            existing.cross_section_material = request.cross_section_material;
+            existing.face_count = request.face_count;
+        }
+        existing.critical = existing.critical || request.critical;
+        existing.sequence = MIN(existing.sequence, request.sequence);
+        return;
+    }
+
+    pending.push_back(request);
+}
+
+void SliceScheduler::process_queue(bool ignore_budget) {
+    if (pending.size() == 0) {
+        set_process(false);
+        return;
+    }
+
+    Slicer *slicer = Object::cast_to<Slicer>(get_node_or_null(slicer_path));
+    ERR_FAIL_COND_MSG(!slicer, "The slicer_path needs to point at a Slicer.");
+
+    Camera *camera = is_inside_tree() ? get_viewport()->get_camera() : NULL;
+    Vector<Plane> frustum;
+    Vector3 camera_position;
+    if (camera) {
+        frustum = camera->get_frustum();
+        camera_position = camera->get_global_transform().origin;
+    }
+
+    // Anything queued while we're working (such as from a slice_completed handler)
+    // goes into pending, and is looked at next frame
+    Vector<Request> queue = pending;
+    pending.clear();
+
+    for (int i = 0; i < queue.size(); i++) {
+        Request &request = queue.ptrw()[i];
+        MeshInstance *instance = Object::cast_to<MeshInstance>(ObjectDB::get_instance(request.instance_id));
+        if (!instance || !camera || !instance->is_inside_tree()) {
+            continue;
+        }
+
+        AABB aabb = instance->get_transformed_aabb();
+        request.on_screen = instance->is_visible_in_tree() && aabb.intersects_convex_shape(frustum.ptr(), frustum.size());
+        request.distance = camera_position.distance_to(aabb.position + aabb.size * 0.5);
+    }
+
+    queue.sort_custom<Request::Comparator>();
+
+    uint64_t start = OS::get_singleton()->get_ticks_usec();
+    int faces = 0;
+    int done = 0;
+
+    for (; done < queue.size(); done++) {
+        const Request &request = queue[done];
+
+        // At least one cut is made every frame, however small the budget, so that nothing waits forever
+        if (!ignore_budget && !request.critical && done > 0) {
+            if (OS::get_singleton()->get_ticks_usec() - start >= (uint64_t)budget_usec) {
+                break;
+            }
+
+            if (budget_faces > 0 && faces + request.face_count > budget_faces) {
+                break;
+            }
+        }
+
+        MeshInstance *instance = Object::cast_to<MeshInstance>(ObjectDB::get_instance(request.instance_id));
+        if (!instance || instance->get_mesh().is_null()) {
+            continue;
+        }
+
+        Transform transform = instance->is_inside_tree() ? instance->get_global_transform() : instance->get_transform();
+        Ref<SlicedMesh> sliced_mesh = slicer->slice(instance->get_mesh(), transform, request.plane.normal * request.plane.d, request.plane.normal, request.cross_section_material);
+        faces += request.face_count;
+
+        emit_signal("slice_completed", instance, sliced_mesh);
+    }
+
+    for (int i = done; i < queue.size(); i++) {
+        add_request(queue[i], false);
+    }
+
+    set_process(pending.size() > 0);
+}
@@ -0,0 +1,133 @@
+#ifndef SLICE_SCHEDULER_H
+#define SLICE_SCHEDULER_H
+
+#include "scene/main/node.h"
+#include "scene/3d/mesh_instance.h"
+#include "slicer.h"
+
+/**
+ * Sits in front of a Slicer and queues up cuts rather than making them straight away,
+ * so that a burst of them (say, from an explosion) gets spread out over several frames
+ * instead of all landing in one. Every frame the most important cuts are made first,
+ * until either the frame's time budget or its face budget runs out, and the rest wait
+ * for the next frame.
+ *
+ * Cuts marked as critical are always made in the frame they're due, then cuts of
+ * instances the camera can see, then everything else, nearest to the camera first.
+ * Queueing a cut of an instance that already has one waiting replaces the waiting
+ * cut's plane rather than cutting the instance twice
+*/
+class SliceScheduler : public Node {
+    GDCLASS(SliceScheduler, Node);
+
+    struct Request {
+        ObjectID instance_id;
+        Plane plane;
+        Ref<Material> cross_section_material;
+        bool critical;
+
+        // When the request was first queued, so that equally important requests go in order
+        uint64_t sequence;
+        int face_count;
+
+        // Worked out each frame, as the camera moves around
+        bool on_screen;
+        real_t distance;
+
+        /**
+         * Sorts the most important requests to the front
+        */
+        struct Comparator {
+            _FORCE_INLINE_ bool operator()(const Request &a, const Request &b) const {
+                if (a.critical != b.critical) {
+                    return a.critical;
+                }
+
+                if (a.on_screen != b.on_screen) {
+                    return a.on_screen;
+                }
+
+                if (a.distance != b.distance) {
+                    return a.distance < b.distance;
+                }
+
+                return a.sequence < b.sequence;
+            }
+        };
+    };
+
+    Vector<Request> pending;
+    uint64_t next_sequence;
+
+    NodePath slicer_path;
+    int budget_usec;
+    int budget_faces;
+
+    /**
+     * Adds the request to the queue, folding it into the request already waiting
+     * on the same instance if there is one
+    */
+    void add_request(const Request &request, bool is_newer);
+
+    /**
+     * Makes the cuts that are due this frame, or every cut if ignore_budget is set
+    */
+    void process_queue(bool ignore_budget);
+
+protected:
+    void _notification(int p_what);
+    static void _bind_methods();
+
+public:
+    void set_slicer_path(const NodePath &p_slicer_path) {
+        slicer_path = p_slicer_path;
+    }
+    NodePath get_slicer_path() const {
+        return slicer_path;
+    }
+
+    void set_budget_usec(int p_budget_usec) {
+        budget_usec = MAX(p_budget_usec, 0);
+    }
+    int get_budget_usec() const {
+        return budget_usec;
+    }
+
+    void set_budget_faces(int p_budget_faces) {
+        budget_faces = MAX(p_budget_faces, 0);
+    }
+    int get_budget_faces() const {
+        return budget_faces;
+    }
+
+    /**
+     * Queues a cut of the instance's mesh along the plane, given in global space. The plane
+     * doesn't need to be normalized, but its normal can't be zero. The slice_completed signal
+     * is emitted once the cut has been made
+    */
+    void queue_slice(Node *instance, const Plane plane, const Ref<Material> cross_section_material, bool critical = false);
+
+    /**
+     * Drops any cut waiting on the instance
+    */
+    void cancel(Node *instance);
+
+    /**
+     * Makes every waiting cut right away, whatever the budget
+    */
+    void flush() {
+        process_queue(true);
+    }
+
+    int get_pending_count() const {
+        return pending.size();
+    }
+
+    SliceScheduler() {
+        next_sequence = 0;
+        budget_usec = 4000;
+        budget_faces = 0;
+    }
+};
+
+#endif // SLICE_SCHEDULER_H
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include "slice_session.h"
+#include "utils/projection_index.h"
+#include "utils/surface_filler.h"
+#include "utils/triangulator.h"
+
+// How close (as a dot product) a plane's normal needs to stay to the direction the faces
+// were sorted along. Past this the window gets wide enough that sorting again is cheaper
+static const real_t RESORT_TOLERANCE = 0.05;
+
+/**
+ * The bounding box of a single face
+*/
+AABB face_aabb(const SlicerFace &face) {
+    AABB aabb(face.vertex[0], Vector3());
+    aabb.expand_to(face.vertex[1]);
+    aabb.expand_to(face.vertex[2]);
+    return aabb;
+}
+
+void SliceSession::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("slice", "plane", "cross_section_material"), &SliceSession::slice, Variant::NIL);
+    ClassDB::bind_method(D_METHOD("get_last_cut_face_count"), &SliceSession::get_last_cut_face_count);
+}
+
+SliceSession::SliceSession(const Vector<SourceSurface> &sources, uint32_t p_cross_section_compression, const Rect2 &p_cross_section_uv_rect, bool p_keep_upper, bool p_keep_lower) {
+    is_sorted = false;
+    radius = 0;
+    cross_section_compression = p_cross_section_compression;
+    cross_section_uv_rect = p_cross_section_uv_rect;
+    keep_upper = p_keep_upper;
+    keep_lower = p_keep_lower;
+    has_last_cut = false;
+    last_cut_face_count = 0;
+
+    surfaces.resize(sources.size());
+    for (int i = 0; i < sources.size(); i++) {
+        Surface &surface = surfaces.ptrw()[i];
+        surface.faces = sources[i].faces;
+        surface.material = sources[i].material;
+        surface.compression = sources[i].compression;
+    }
+}
+
+void SliceSession::sort_faces(const Vector3 &p_direction) {
+    direction = p_direction;
+    is_sorted = true;
+    radius = 0;
+
+    PoolVector<Vector3> directions;
+    directions.push_back(direction);
+
+    for (int i = 0; i < surfaces.size(); i++) {
+        Surface &surface = surfaces.ptrw()[i];
+        int face_count = surface.faces.size();
+        if (face_count == 0) {
+            continue;
+        }
+
+        ProjectionIndex index;
+        index.build(surface.faces, directions);
+        const ProjectionIndex::Axis &axis = index.axes[0];
+
+        radius = MAX(radius, index.radius);
+        surface.mins = axis.mins;
+        surface.maxs = axis.maxs;
+        surface.max_extent = axis.max_extent;
+
+        Vector<SlicerFace> sorted;
+        sorted.resize(face_count);
+        {
+            const SlicerFace *faces_reader = surface.faces.ptr();
+            SlicerFace *sorted_writer = sorted.ptrw();
+            for (int j = 0; j < face_count; j++) {
+                sorted_writer[j] = faces_reader[axis.order[j]];
+            }
+        }
+        surface.faces = sorted;
+
+        SurfaceFiller filler(surface.faces, surface.compression);
+        for (int j = 0; j < face_count * 3; j++) {
+            filler.fill(j, j);
+        }
+
+        surface.format = filler.format;
+        surface.stride = filler.stride;
+        surface.vertex_array = filler.get_vertex_array();
+        surface.bone_aabbs = filler.bone_aabbs;
+
+        surface.head_aabbs.resize(face_count + 1);
+        surface.tail_aabbs.resize(face_count + 1);
+
+        const SlicerFace *faces_reader = surface.faces.ptr();
+        for (int j = 0; j < face_count; j++) {
+            AABB aabb = face_aabb(faces_reader[j]);
+            surface.head_aabbs.ptrw()[j + 1] = j == 0 ? aabb : surface.head_aabbs[j].merge(aabb);
+        }
+
+        for (int j = face_count - 1; j >= 0; j--) {
+            AABB aabb = face_aabb(faces_reader[j]);
+            surface.tail_aabbs.ptrw()[j] = j == face_count - 1 ? aabb : surface.tail_aabbs[j + 1].merge(aabb);
+        }
+    }
+}
+
+Ref<SlicedMesh> SliceSession::slice(const Plane p_plane, const Ref<Material> cross_section_material) {
+    ERR_FAIL_COND_V(p_plane.normal == Vector3(), Ref<SlicedMesh>());
+
+    // The faces are sorted by their projection onto the normalized direction, so the
+    // window around d only lines up with them if the normal is a unit vector too
+    Plane plane = p_plane.normalized();
+
+    if (has_last_cut && plane == last_plane && cross_section_material == last_cross_section_material) {
+        return sliced_mesh;
+    }
+
+    has_last_cut = false;
+    last_cut_face_count = 0;
+
+    if (!is_sorted || direction.dot(plane.normal) < 1 - RESORT_TOLERANCE) {
+        sort_faces(plane.normal);
+    }
+
+    // Same windowing as ProjectionIndex::split_by_plane, only the window is left in
+    // place for write_half rather than having the faces on either side of it copied out
+    real_t slack = (plane.normal - direction).length() * radius;
+    real_t low = plane.d - CMP_EPSILON - slack;
+    real_t high = plane.d + CMP_EPSILON + slack;
+
+    Vector<Vector3> intersection_points;
+
+    for (int i = 0; i < surfaces.size(); i++) {
+        Surface &surface = surfaces.ptrw()[i];
+        int face_count = surface.faces.size();
+
+        surface.window_result = Intersector::SplitResult();
+        surface.window_result.keep_upper = keep_upper;
+        surface.window_result.keep_lower = keep_lower;
+
+        const real_t *mins = surface.mins.ptr();
+        surface.window_start = std::lower_bound(mins, mins + face_count, low - surface.max_extent) - mins;
+        surface.window_end = std::upper_bound(mins, mins + face_count, high) - mins;
+
+        const SlicerFace *faces_reader = surface.faces.ptr();
+        for (int j = surface.window_start; j < surface.window_end; j++) {
+            if (surface.maxs[j] < low) {
+                if (keep_lower) {
+                    surface.window_result.lower_faces.push_back(faces_reader[j]);
+                }
+            } else {
+                Intersector::split_face_by_plane(plane, faces_reader[j], surface.window_result);
+            }
+        }
+
+        last_cut_face_count += surface.window_end - surface.window_start;
+
+        intersection_points.append_array(surface.window_result.intersection_points);
+        surface.window_result.intersection_points.resize(0);
+    }
+
+    if (intersection_points.size() == 0) {
+        return Ref<SlicedMesh>();
+    }
+
+    Vector<SlicerFace> cross_section_faces = Triangulator::monotone_chain(intersection_points, plane.normal, cross_section_uv_rect);
+    SurfaceFiller *cross_section = pack_cross_section(cross_section_faces, cross_section_compression);
+
+    if (sliced_mesh.is_null()) {
+        sliced_mesh.instance();
+    }
+
+    if (keep_upper) {
+        if (upper_mesh.is_null()) {
+            upper_mesh.instance();
+        }
+        write_half(cross_section, cross_section_material, true, **upper_mesh);
+    }
+
+    if (keep_lower) {
+        if (lower_mesh.is_null()) {
+            lower_mesh.instance();
+        }
+        write_half(cross_section, cross_section_material, false, **lower_mesh);
+    }
+
+    sliced_mesh->upper_mesh = upper_mesh;
+    sliced_mesh->lower_mesh = lower_mesh;
+
+    if (cross_section) {
+        memdelete(cross_section);
+    }
+
+    has_last_cut = true;
+    last_plane = plane;
+    last_cross_section_material = cross_section_material;
+    return sliced_mesh;
+}
+
+void SliceSession::write_half(const SurfaceFiller *cross_section, Ref<Material> cross_section_material, bool is_upper, ArrayMesh &mesh) {
+    int surface_count = 0;
+
+    for (int i = 0; i < surfaces.size(); i++) {
+        const Surface &surface = surfaces[i];
+        const Vector<SlicerFace> &window_faces = is_upper ? surface.window_result.upper_faces : surface.window_result.lower_faces;
+
+        // The faces past the window are all above the plane and the faces before it all below
+        int stable_start = is_upper ? surface.window_end : 0;
+        int stable_count = is_upper ? surface.faces.size() - surface.window_end : surface.window_start;
+        int face_count = stable_count + window_faces.size();
+        if (face_count == 0) {
+            continue;
+        }
+
+        SurfaceFiller filler(surface.format, PoolVector<uint8_t>(), 0, 0);
+        filler.resize_vertexes(face_count * 3);
+
+        if (stable_count > 0) {
+            PoolVector<uint8_t>::Read vertex_reader = surface.vertex_array.read();
+            int face_size = 3 * surface.stride;
+            copymem(filler.vertex_writer.ptr(), vertex_reader.ptr() + stable_start * face_size, stable_count * face_size);
+
+            filler.aabb = is_upper ? surface.tail_aabbs[stable_start] : surface.head_aabbs[stable_count];
+            filler.has_aabb = true;
+        }
+
+        const SlicerFace *window_reader = window_faces.ptr();
+        for (int j = 0; j < window_faces.size(); j++) {
+            for (int k = 0; k < 3; k++) {
+                filler.fill_vertex(window_reader[j], k, (stable_count + j) * 3 + k);
+            }
+        }
+
+        if (filler.has_bones) {
+            filler.bone_aabbs = surface.bone_aabbs;
+        }
+
+        filler.write_to_mesh(mesh, surface_count, surface.material);
+        surface_count++;
+    }
+
+    if (cross_section_material.is_null() && surface_count > 0) {
+        cross_section_material = mesh.surface_get_material(0);
+    }
+
+    if (create_cross_section_surface(cross_section, cross_section_material, mesh, surface_count, is_upper)) {
+        surface_count++;
+    }
+
+    while (mesh.get_surface_count() > surface_count) {
+        mesh.surface_remove(mesh.get_surface_count() - 1);
+    }
+}
@@ -0,0 +1,139 @@
+#ifndef SLICE_SESSION_H
+#define SLICE_SESSION_H
+
+#include "core/reference.h"
+#include "sliced_mesh.h"
+#include "utils/cell_mesh.h"
+
+/**
+ * Keeps a mesh ready to be cut over and over by a plane that only moves a little
+ * between cuts, like a cutaway view being dragged around or a preview of where a
+ * cut is going to land.
+ *
+ * The faces of each surface are sorted once by how far along the plane's normal
+ * they sit, and packed into a vertex buffer in that order. After that, a cut only
+ * has to look at the faces in a window around the plane. Everything before the
+ * window is below it and everything after is above it, so those parts of the
+ * vertex buffer are copied over as they are rather than being repacked.
+ *
+ * The same SlicedMesh (and the same pair of meshes) is handed back by every cut,
+ * so hold on to the session rather than the results. If the mesh itself changes
+ * a new session needs to be created
+*/
+class SliceSession : public Reference {
+    GDCLASS(SliceSession, Reference);
+
+    struct Surface {
+        Ref<Material> material;
+        uint32_t compression;
+
+        // The VisualServer format and vertex size the faces were packed with
+        uint32_t format;
+        uint32_t stride;
+
+        // Faces sorted by their lowest projection along the session's direction, the
+        // lowest and highest projection of each face in that order, and the faces
+        // packed into a vertex buffer in that same order
+        Vector<SlicerFace> faces;
+        Vector<real_t> mins;
+        Vector<real_t> maxs;
+        PoolVector<uint8_t> vertex_array;
+
+        // The furthest apart any one face's projections are
+        real_t max_extent;
+
+        // head_aabbs[i] bounds the first i faces and tail_aabbs[i] bounds every face from
+        // i onwards, so the faces copied over as they are never need to be looked at again
+        Vector<AABB> head_aabbs;
+        Vector<AABB> tail_aabbs;
+
+        // The bone AABBs of the whole surface. Each half just uses these as they are,
+        // which culls a little less tightly than it could
+        Vector<AABB> bone_aabbs;
+
+        // Where the last cut's window started and ended and what came out of cutting it
+        int window_start;
+        int window_end;
+        Intersector::SplitResult window_result;
+
+        Surface() {
+            compression = Mesh::ARRAY_COMPRESS_DEFAULT;
+            format = 0;
+            stride = 0;
+            max_extent = 0;
+            window_start = 0;
+            window_end = 0;
+        }
+    };
+
+    Vector<Surface> surfaces;
+
+    // The direction the faces are currently sorted along. Planes that stray too far from
+    // it cause the faces to be sorted again along the new plane's normal
+    Vector3 direction;
+    bool is_sorted;
+
+    // Distance of the furthest vertex from the origin, used to widen the window when the
+    // plane isn't facing exactly along our direction (see ProjectionIndex)
+    real_t radius;
+
+    uint32_t cross_section_compression;
+    Rect2 cross_section_uv_rect;
+    bool keep_upper;
+    bool keep_lower;
+
+    bool has_last_cut;
+    Plane last_plane;
+    Ref<Material> last_cross_section_material;
+
+    Ref<SlicedMesh> sliced_mesh;
+    Ref<ArrayMesh> upper_mesh;
+    Ref<ArrayMesh> lower_mesh;
+
+    int last_cut_face_count;
+
+    /**
+     * Sorts and packs every surface along the given direction
+    */
+    void sort_faces(const Vector3 &p_direction);
+
+    /**
+     * Writes one half of the last cut into the mesh, copying the parts of each
+     * surface that were entirely on that side straight out of the sorted buffer
+    */
+    void write_half(const SurfaceFiller *cross_section, Ref<Material> cross_section_material, bool is_upper, ArrayMesh &mesh);
+
+protected:
+    static void _bind_methods();
+
+public:
+    /**
+     * Cuts the mesh along the plane, returning null if the plane doesn't touch it.
+     * The plane doesn't need to be normalized, but its normal can't be zero.
+     * Cutting along the same plane as last time just hands back the last result
+    */
+    Ref<SlicedMesh> slice(const Plane p_plane, const Ref<Material> cross_section_material);
+
+    /**
+     * How many faces the last cut had to look at one by one rather than copying over
+     * with the rest of their half. Handy for seeing how much a session is saving
+    */
+    int get_last_cut_face_count() const {
+        return last_cut_face_count;
+    }
+
+    SliceSession(const Vector<SourceSurface> &sources, uint32_t p_cross_section_compression, const Rect2 &p_cross_section_uv_rect, bool p_keep_upper, bool p_keep_lower);
+
+    SliceSession() {
+        is_sorted = false;
+        radius = 0;
+        cross_section_compression = Mesh::ARRAY_COMPRESS_DEFAULT;
+        cross_section_uv_rect = Rect2(0, 0, 1, 1);
+        keep_upper = true;
+        keep_lower = true;
+        has_last_cut = false;
+        last_cut_face_count = 0;
+    }
+};
+
+#endif // SLICE_SESSION_H
@@ -0,0 +1,49 @@
+#include "sliced_arrays.h"
+#include "utils/array_filler.h"
+
+/**
+ * Writes the faces out as arrays, optionally with their winding reversed
+ * (see create_cross_section_surface in sliced_mesh.cpp for why)
+*/
+Array create_arrays(const Vector<SlicerFace> &faces, bool reversed) {
+    if (faces.size() == 0) {
+        return Array();
+    }
+
+    ArrayFiller filler(faces);
+    for (int i = 0; i < faces.size() * 3; i += 3) {
+        filler.fill(i, i);
+        filler.fill(i + 1, reversed ? i + 2 : i + 1);
+        filler.fill(i + 2, reversed ? i + 1 : i + 2);
+    }
+
+    return filler.get_arrays();
+}
+
+void SlicedArrays::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_upper_arrays", "arrays"), &SlicedArrays::set_upper_arrays);
+    ClassDB::bind_method(D_METHOD("get_upper_arrays"), &SlicedArrays::get_upper_arrays);
+    ClassDB::bind_method(D_METHOD("set_lower_arrays", "arrays"), &SlicedArrays::set_lower_arrays);
+    ClassDB::bind_method(D_METHOD("get_lower_arrays"), &SlicedArrays::get_lower_arrays);
+    ClassDB::bind_method(D_METHOD("set_upper_cross_section_arrays", "arrays"), &SlicedArrays::set_upper_cross_section_arrays);
+    ClassDB::bind_method(D_METHOD("get_upper_cross_section_arrays"), &SlicedArrays::get_upper_cross_section_arrays);
+    ClassDB::bind_method(D_METHOD("set_lower_cross_section_arrays", "arrays"), &SlicedArrays::set_lower_cross_section_arrays);
+    ClassDB::bind_method(D_METHOD("get_lower_cross_section_arrays"), &SlicedArrays::get_lower_cross_section_arrays);
+
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "upper_arrays"), "set_upper_arrays", "get_upper_arrays");
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "lower_arrays"), "set_lower_arrays", "get_lower_arrays");
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "upper_cross_section_arrays"), "set_upper_cross_section_arrays", "get_upper_cross_section_arrays");
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "lower_cross_section_arrays"), "set_lower_cross_section_arrays", "get_lower_cross_section_arrays");
+}
+
+SlicedArrays::SlicedArrays(const Intersector::SplitResult &split, const Vector<SlicerFace> &cross_section_faces) {
+    if (split.keep_upper) {
+        upper_arrays = create_arrays(split.upper_faces, false);
+        upper_cross_section_arrays = create_arrays(cross_section_faces, true);
+    }
+
+    if (split.keep_lower) {
+        lower_arrays = create_arrays(split.lower_faces, false);
+        lower_cross_section_arrays = create_arrays(cross_section_faces, false);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef SLICED_ARRAYS_H
+#define SLICED_ARRAYS_H
+
+#include "core/reference.h"
+#include "scene/resources/mesh.h"
+#include "utils/intersector.h"
+
+/**
+ * The result of slicing a set of Mesh::ARRAY_* arrays directly. Rather than meshes
+ * this holds the arrays for each half, and for each half's cross section, ready to be
+ * handed to whatever wants them. No meshes (and so nothing on the VisualServer) are
+ * created along the way
+*/
+class SlicedArrays : public Reference {
+    GDCLASS(SlicedArrays, Reference);
+
+protected:
+    static void _bind_methods();
+
+public:
+    Array upper_arrays;
+    Array lower_arrays;
+
+    // The cross section wound to face out of each half
+    Array upper_cross_section_arrays;
+    Array lower_cross_section_arrays;
+
+    void set_upper_arrays(const Array &p_upper_arrays) {
+        upper_arrays = p_upper_arrays;
+    }
+    Array get_upper_arrays() const {
+        return upper_arrays;
+    }
+
+    void set_lower_arrays(const Array &p_lower_arrays) {
+        lower_arrays = p_lower_arrays;
+    }
+    Array get_lower_arrays() const {
+        return lower_arrays;
+    }
+
+    void set_upper_cross_section_arrays(const Array &p_upper_cross_section_arrays) {
+        upper_cross_section_arrays = p_upper_cross_section_arrays;
+    }
+    Array get_upper_cross_section_arrays() const {
+        return upper_cross_section_arrays;
+    }
+
+    void set_lower_cross_section_arrays(const Array &p_lower_cross_section_arrays) {
+        lower_cross_section_arrays = p_lower_cross_section_arrays;
+    }
+    Array get_lower_cross_section_arrays() const {
+        return lower_cross_section_arrays;
+    }
+
+    /**
+     * Turns a split result and the faces of its cross section into arrays. Halves that are
+     * empty, or that the split wasn't keeping, are left as empty Arrays
+    */
+    SlicedArrays(const Intersector::SplitResult &split, const Vector<SlicerFace> &cross_section_faces);
+
+    SlicedArrays() {}
+};
+
+#endif // SLICED_ARRAYS_H
@@ -1,81 +1,311 @@
 #include "sliced_mesh.h"
 #include "utils/surface_filler.h"
+#include "utils/mesh_pool.h"
 
 /*
- * Creates a new surface composed of the uncut faces that were above the plane and the new faces generated
- * from the cut faces that fell on the plane
+ * Packs the uncut faces that were on one side of the plane, along with the new faces generated from
+ * the cut faces that fell on that side, into a new surface. Like the other pack_* functions this doesn't
+ * write the surface anywhere yet (see SurfaceFiller::write_to_mesh), and returns NULL if there are no faces
 */
-void create_surface(const PoolVector<SlicerFace> &faces, const Ref<Material> material, ArrayMesh &mesh) {
+SurfaceFiller *pack_surface(const Vector<SlicerFace> &faces, uint32_t compression) {
     if (faces.size() == 0) {
-        return;
+        return NULL;
     }
 
-    SurfaceFiller filler(faces);
+    SurfaceFiller *filler = memnew(SurfaceFiller(faces, compression));
 
     for (int i = 0; i < faces.size() * 3; i++) {
-        filler.fill(i, i);
+        filler->fill(i, i);
     }
 
-    filler.add_to_mesh(mesh, material);
+    return filler;
 }
 
 /**
- * Create a new surface of the cross section faces. This should be called twice: once for the upper_mesh
- * and again for the lower_mesh
+ * Packs a new surface out of faces that all point into the vertex buffer that is shared
+ * with the surface they were cut from, so that only an index buffer needs to be written.
+ * Any extra_faces (such as a merged in cross section) don't exist in that buffer yet and
+ * get appended onto the end of it
 */
-void create_cross_section_surface(const PoolVector<SlicerFace> &faces, const Ref<Material> material, ArrayMesh &mesh, bool is_upper) {
+SurfaceFiller *pack_shared_surface(const Vector<SlicerFace> &faces, const Intersector::SplitResult &split, const Vector<SlicerFace> &extra_faces) {
     if (faces.size() == 0) {
-        return;
+        return NULL;
     }
 
-    SurfaceFiller filler(faces);
+    SurfaceFiller *filler = memnew(SurfaceFiller(split.shared_format, split.shared_vertex_array, split.shared_vertex_count, 0));
 
+    // The width of the indexes depends on the final vertex count, so the vertex
+    // buffer needs to be grown before the index buffer can be allocated
+    if (extra_faces.size() > 0) {
+        filler->resize_vertexes(split.shared_vertex_count + extra_faces.size() * 3);
+    }
+    filler->resize_indexes((faces.size() + extra_faces.size()) * 3);
+
+    const SlicerFace *faces_reader = faces.ptr();
     for (int i = 0; i < faces.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            filler->track(faces_reader[i], j);
+            filler->set_index(i * 3 + j, faces_reader[i].source_index[j]);
+        }
+    }
+
+    const SlicerFace *extra_reader = extra_faces.ptr();
+    int index_offset = faces.size() * 3;
+    for (int i = 0; i < extra_faces.size() * 3; i++) {
+        int vertex_idx = split.shared_vertex_count + i;
+        filler->fill_vertex(extra_reader[i / 3], i % 3, vertex_idx);
+        filler->set_index(index_offset + i, vertex_idx);
+    }
+
+    return filler;
+}
+
+/**
+ * Whether the faces of a split are skinned. We don't have anything sensible to
+ * weight a cross section to, so these never get one merged into them
+*/
+bool is_skinned(const Intersector::SplitResult &split, const Vector<SlicerFace> &faces) {
+    if (split.shared_vertex_count > 0) {
+        return split.shared_format & (Mesh::ARRAY_FORMAT_BONES | Mesh::ARRAY_FORMAT_WEIGHTS);
+    }
+
+    return faces[0].has_bones || faces[0].has_weights;
+}
+
+/**
+ * Finds the split whose surface the cross section can be merged into for the given half,
+ * or -1 if there isn't one. A null material stands for the material of whatever ends up as
+ * the half's first surface, the same as when the cross section gets its own surface. Skinned
+ * surfaces are passed over in favour of any later one with the same material
+*/
+int find_merge_target(const Vector<Intersector::SplitResult> &surface_splits, const Ref<Material> cross_section_material, bool is_upper) {
+    Ref<Material> material = cross_section_material;
+    bool has_material = material.is_valid();
+
+    for (int i = 0; i < surface_splits.size(); i++) {
+        const Intersector::SplitResult &split = surface_splits[i];
+        const Vector<SlicerFace> &faces = is_upper ? split.upper_faces : split.lower_faces;
+
+        if (faces.size() == 0) {
+            continue;
+        }
+
+        if (!has_material) {
+            material = split.material;
+            has_material = true;
+        }
+
+        if (split.material == material && !is_skinned(split, faces)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Copies the cross section faces into the winding of the given half and gives them the
+ * same set of attributes as the faces of the surface they're being merged into, filling
+ * in defaults for anything the cross section doesn't have
+*/
+Vector<SlicerFace> conform_cross_section(const Vector<SlicerFace> &cross_section_faces, const SlicerFace &like, bool is_upper) {
+    Vector<SlicerFace> result;
+    result.resize(cross_section_faces.size());
+
+    const SlicerFace *faces_reader = cross_section_faces.ptr();
+    SlicerFace *result_writer = result.ptrw();
+
+    for (int i = 0; i < cross_section_faces.size(); i++) {
+        const SlicerFace &face = faces_reader[i];
+        SlicerFace &conformed = result_writer[i];
+
+        // Same reasoning as in create_cross_section_surface
+        int order[3] = { 0, is_upper ? 2 : 1, is_upper ? 1 : 2 };
+
+        for (int j = 0; j < 3; j++) {
+            conformed.vertex[j] = face.vertex[order[j]];
+            conformed.normal[j] = face.normal[order[j]];
+            conformed.tangent[j] = face.tangent[order[j]];
+            conformed.uv[j] = face.uv[order[j]];
+            conformed.color[j] = Color(1, 1, 1, 1);
+            conformed.uv2[j] = Vector2();
+        }
+
+        conformed.has_normals = like.has_normals;
+        conformed.has_tangents = like.has_tangents;
+        conformed.has_colors = like.has_colors;
+        conformed.has_uvs = like.has_uvs;
+        conformed.has_uv2s = like.has_uv2s;
+    }
+
+    return result;
+}
+
+/**
+ * Returns a copy of faces with extra_faces added to the end
+*/
+Vector<SlicerFace> concat_faces(const Vector<SlicerFace> &faces, const Vector<SlicerFace> &extra_faces) {
+    Vector<SlicerFace> result = faces;
+    int size = result.size();
+    result.resize(size + extra_faces.size());
+
+    const SlicerFace *extra_reader = extra_faces.ptr();
+    SlicerFace *result_writer = result.ptrw();
+    for (int i = 0; i < extra_faces.size(); i++) {
+        result_writer[size + i] = extra_reader[i];
+    }
+
+    return result;
+}
+
+/**
+ * Packs the cross section faces into a vertex buffer. The cross section is identical for the upper
+ * and lower halves except for its winding, so this is only done once and the resulting buffer is
+ * shared between both meshes (see create_cross_section_surface)
+*/
+SurfaceFiller *pack_cross_section(const Vector<SlicerFace> &faces, uint32_t compression) {
+    if (faces.size() == 0) {
+        return NULL;
+    }
+
+    SurfaceFiller *filler = memnew(SurfaceFiller(faces, compression));
+    for (int i = 0; i < faces.size() * 3; i++) {
+        filler->fill(i, i);
+    }
+
+    filler->get_vertex_array();
+    return filler;
+}
+
+/**
+ * Create a new surface of the packed cross section faces. This should be called twice: once for the upper_mesh
+ * and again for the lower_mesh. Only the index buffer is unique to each call
+*/
+bool create_cross_section_surface(const SurfaceFiller *cross_section, const Ref<Material> material, ArrayMesh &mesh, int surface_idx, bool is_upper) {
+    if (!cross_section) {
+        return false;
+    }
+
+    SurfaceFiller filler(cross_section->format, cross_section->vertex_array, cross_section->vertex_count, cross_section->vertex_count);
+    filler.has_aabb = cross_section->has_aabb;
+    filler.aabb = cross_section->aabb;
+
+    for (int i = 0; i < cross_section->vertex_count; i += 3) {
         // The cross section faces have the same normal as the plane that cut
         // them. That means that, for the upper half of the cut, we want to add
         // the vertexes counterclockwise so that the normal is facing outwards
         if (is_upper) {
-            filler.fill(i * 3, i * 3);
-            filler.fill(i * 3 + 1, i * 3 + 2);
-            filler.fill(i * 3 + 2, i * 3 + 1);
+            filler.set_index(i, i);
+            filler.set_index(i + 1, i + 2);
+            filler.set_index(i + 2, i + 1);
         } else {
-            filler.fill(i * 3, i * 3);
-            filler.fill(i * 3 + 1, i * 3 + 1);
-            filler.fill(i * 3 + 2, i * 3 + 2);
+            filler.set_index(i, i);
+            filler.set_index(i + 1, i + 1);
+            filler.set_index(i + 2, i + 2);
         }
     }
 
-    filler.add_to_mesh(mesh, material);
+    filler.write_to_mesh(mesh, surface_idx, material);
+    return true;
+}
+
+SurfaceFiller *pack_half_surface(const Intersector::SplitResult &split, const Vector<SlicerFace> &merged_cross_section_faces, bool is_upper) {
+    const Vector<SlicerFace> &faces = is_upper ? split.upper_faces : split.lower_faces;
+    if (faces.size() == 0) {
+        return NULL;
+    }
+
+    Vector<SlicerFace> extra_faces;
+    if (merged_cross_section_faces.size() > 0) {
+        extra_faces = conform_cross_section(merged_cross_section_faces, faces[0], is_upper);
+    }
+
+    if (split.shared_vertex_count > 0) {
+        return pack_shared_surface(faces, split, extra_faces);
+    } else if (extra_faces.size() > 0) {
+        return pack_surface(concat_faces(faces, extra_faces), split.compression);
+    } else {
+        return pack_surface(faces, split.compression);
+    }
+}
+
+/**
+ * Finishes off a half once its surface_count surfaces have been written, adding the cross section
+ * as a surface of its own (unless it was merged into merge_target) and dropping anything left over
+*/
+void finish_mesh_half(const SurfaceFiller *cross_section, Ref<Material> cross_section_material, int merge_target, bool is_upper, int surface_count, ArrayMesh &mesh) {
+    if (merge_target < 0) {
+        if (cross_section_material.is_null() && surface_count > 0) {
+            // I believe Ezy-Slice has a way of specifying the existing material to use,
+            // we may want to add that as a TODO
+            cross_section_material = mesh.surface_get_material(0);
+        }
+
+        if (create_cross_section_surface(cross_section, cross_section_material, mesh, surface_count, is_upper)) {
+            surface_count++;
+        }
+    }
+
+    // Anything left over belonged to whatever was in the mesh before
+    while (mesh.get_surface_count() > surface_count) {
+        mesh.surface_remove(mesh.get_surface_count() - 1);
+    }
 }
 
 /**
- * Creates either an upper or lower half of the sliced mesh
+ * Writes either an upper or lower half of the sliced mesh into the given mesh, replacing any
+ * surfaces it already had. Surfaces that line up with the new ones are updated in place
 */
-Mesh* create_mesh_half(
-    const PoolVector<Intersector::SplitResult> &surface_splits,
-    const PoolVector<SlicerFace> &cross_section_faces,
+void create_mesh_half(
+    const Vector<Intersector::SplitResult> &surface_splits,
+    const Vector<SlicerFace> &cross_section_faces,
+    const SurfaceFiller *cross_section,
     Ref<Material> cross_section_material,
-    bool is_upper
+    bool merge_cross_section,
+    bool is_upper,
+    ArrayMesh &mesh
 ) {
-    ArrayMesh *mesh = memnew(ArrayMesh);
+    int surface_count = 0;
+    int merge_target = merge_cross_section && cross_section ? find_merge_target(surface_splits, cross_section_material, is_upper) : -1;
 
+    // Each surface is written as soon as it's packed, so only one is ever held on to at a time
     for (int i = 0; i < surface_splits.size(); i++) {
-        if (is_upper) {
-            create_surface(surface_splits[i].upper_faces, surface_splits[i].material, *mesh);
-        } else {
-            create_surface(surface_splits[i].lower_faces, surface_splits[i].material, *mesh);
+        const Intersector::SplitResult &split = surface_splits[i];
+        SurfaceFiller *filler = pack_half_surface(split, i == merge_target ? cross_section_faces : Vector<SlicerFace>(), is_upper);
+        if (filler) {
+            filler->write_to_mesh(mesh, surface_count, split.material);
+            memdelete(filler);
+            surface_count++;
         }
     }
 
+    finish_mesh_half(cross_section, cross_section_material, merge_target, is_upper, surface_count, mesh);
+}
 
-    if (cross_section_material.is_null() && mesh->get_surface_count() > 0) {
-        // I believe Ezy-Slice has a way of specifying the existing material to use,
-        // we may want to add that as a TODO
-        cross_section_material = mesh->surface_get_material(0);
+/**
+ * The same as create_mesh_half but for a half that has already been packed
+*/
+void write_mesh_half(const Vector<Intersector::SplitResult> &surface_splits, const PackedHalf &half, const SurfaceFiller *cross_section, Ref<Material> cross_section_material, bool is_upper, ArrayMesh &mesh) {
+    int surface_count = 0;
+    for (int i = 0; i < half.surfaces.size(); i++) {
+        if (half.surfaces[i]) {
+            half.surfaces[i]->write_to_mesh(mesh, surface_count, surface_splits[i].material);
+            surface_count++;
+        }
     }
 
-    create_cross_section_surface(cross_section_faces, cross_section_material, *mesh, is_upper);
-    return mesh;
+    finish_mesh_half(cross_section, cross_section_material, half.merge_target, is_upper, surface_count, mesh);
+}
+
+/**
+ * Counts how many faces ended up in a half
+*/
+int count_half_faces(const Vector<Intersector::SplitResult> &surface_splits, bool is_upper) {
+    int count = 0;
+    for (int i = 0; i < surface_splits.size(); i++) {
+        count += is_upper ? surface_splits[i].upper_faces.size() : surface_splits[i].lower_faces.size();
+    }
+    return count;
 }
 
 void SlicedMesh::_bind_methods() {
@@ -88,7 +318,86 @@ void SlicedMesh::_bind_methods() {
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "lower_mesh", PROPERTY_HINT_RESOURCE_TYPE, "Mesh"), "set_lower_mesh", "get_lower_mesh");
 }
 
-SlicedMesh::SlicedMesh(const PoolVector<Intersector::SplitResult> &surface_splits, const PoolVector<SlicerFace> &cross_section_faces, const Ref<Material> cross_section_material) {
-    upper_mesh = Ref<Mesh>(create_mesh_half(surface_splits, cross_section_faces, cross_section_material, true));
-    lower_mesh = Ref<Mesh>(create_mesh_half(surface_splits, cross_section_faces, cross_section_material, false));
+SlicedMesh::SlicedMesh(const Vector<Intersector::SplitResult> &surface_splits, const Vector<SlicerFace> &cross_section_faces, const Ref<Material> cross_section_material, uint32_t cross_section_compression, bool merge_cross_section, bool keep_upper, bool keep_lower) {
+    create_halves(surface_splits, cross_section_faces, cross_section_material, cross_section_compression, merge_cross_section, keep_upper, keep_lower, NULL, Ref<ArrayMesh>());
+}
+
+/**
+ * Picks the mesh each kept half gets written into. The reused mesh goes to whichever half is
+ * larger, so that the half that's more likely to carry on being cut (and to have surfaces that
+ * can be updated in place) keeps it
+*/
+void pick_half_meshes(const Vector<Intersector::SplitResult> &surface_splits, bool keep_upper, bool keep_lower, MeshPool *pool, const Ref<ArrayMesh> &reused_mesh, Ref<ArrayMesh> r_meshes[2]) {
+    bool reuse_for_upper = false;
+    bool reuse_for_lower = false;
+    if (reused_mesh.is_valid()) {
+        if (keep_upper && keep_lower) {
+            reuse_for_upper = count_half_faces(surface_splits, true) >= count_half_faces(surface_splits, false);
+            reuse_for_lower = !reuse_for_upper;
+        } else {
+            reuse_for_upper = keep_upper;
+            reuse_for_lower = keep_lower;
+        }
+    }
+
+    for (int i = 0; i < 2; i++) {
+        bool is_upper = i == 0;
+        r_meshes[i] = Ref<ArrayMesh>();
+        if (!(is_upper ? keep_upper : keep_lower)) {
+            continue;
+        }
+
+        if (is_upper ? reuse_for_upper : reuse_for_lower) {
+            r_meshes[i] = reused_mesh;
+        } else if (pool) {
+            r_meshes[i] = pool->take_mesh();
+        } else {
+            r_meshes[i].instance();
+        }
+    }
+}
+
+void SlicedMesh::create_halves(const Vector<Intersector::SplitResult> &surface_splits, const Vector<SlicerFace> &cross_section_faces, Ref<Material> cross_section_material, uint32_t cross_section_compression, bool merge_cross_section, bool keep_upper, bool keep_lower, MeshPool *pool, const Ref<ArrayMesh> &reused_mesh) {
+    SurfaceFiller *cross_section = pack_cross_section(cross_section_faces, cross_section_compression);
+
+    Ref<ArrayMesh> meshes[2];
+    pick_half_meshes(surface_splits, keep_upper, keep_lower, pool, reused_mesh, meshes);
+
+    for (int i = 0; i < 2; i++) {
+        if (meshes[i].is_valid()) {
+            create_mesh_half(surface_splits, cross_section_faces, cross_section, cross_section_material, merge_cross_section, i == 0, **meshes[i]);
+        }
+    }
+
+    upper_mesh = meshes[0];
+    lower_mesh = meshes[1];
+
+    if (cross_section) {
+        memdelete(cross_section);
+    }
+}
+
+void SlicedMesh::write_halves(const Vector<Intersector::SplitResult> &surface_splits, const PackedHalf halves[2], const SurfaceFiller *cross_section, Ref<Material> cross_section_material, bool keep_upper, bool keep_lower, MeshPool *pool, const Ref<ArrayMesh> &reused_mesh) {
+    Ref<ArrayMesh> meshes[2];
+    pick_half_meshes(surface_splits, keep_upper, keep_lower, pool, reused_mesh, meshes);
+
+    for (int i = 0; i < 2; i++) {
+        if (meshes[i].is_valid()) {
+            write_mesh_half(surface_splits, halves[i], cross_section, cross_section_material, i == 0, **meshes[i]);
+        }
+    }
+
+    upper_mesh = meshes[0];
+    lower_mesh = meshes[1];
+}
+
+void PackedHalf::clear() {
+    for (int i = 0; i < surfaces.size(); i++) {
+        if (surfaces[i]) {
+            memdelete(surfaces[i]);
+        }
+    }
+
+    surfaces.clear();
+    merge_target = -1;
 }
@@ -5,6 +5,32 @@
 #include "scene/resources/mesh.h"
 #include "utils/intersector.h"
 
+struct MeshPool;
+struct SurfaceFiller;
+
+/**
+ * The surfaces of one half of a cut, packed into vertex buffers but not written into a mesh
+ * yet. Packing is most of the work of building a half and, unlike writing, doesn't go through
+ * the VisualServer, so it can be done off the main thread (see Slicer::slice_by_plane)
+*/
+struct PackedHalf {
+    // One for each split, NULL where the split left no faces in this half
+    Vector<SurfaceFiller *> surfaces;
+
+    // The surface the cross section was merged into, or -1 if it gets one of its own
+    int merge_target;
+
+    void clear();
+
+    PackedHalf() {
+        merge_target = -1;
+    }
+
+    ~PackedHalf() {
+        clear();
+    }
+};
+
 /**
  * A simple container for the results of a mesh slice.
  * upper_mesh contains the part of the mesh that was above
@@ -42,11 +68,51 @@ public:
 
     /**
      * Transforms a vector of split results and a vector of faces representing
-     * the cross section of a slice and creates an upper and lower mesh from them
+     * the cross section of a slice and creates an upper and lower mesh from them.
+     * If merge_cross_section is set, the cross section is added to the surface that
+     * shares its material (if there is one) rather than getting a surface of its own.
+     * Halves that aren't being kept are left null
     */
-    SlicedMesh(const PoolVector<Intersector::SplitResult> &surface_splits, const PoolVector<SlicerFace> &cross_section_faces, Ref<Material> cross_section_material);
+    SlicedMesh(const Vector<Intersector::SplitResult> &surface_splits, const Vector<SlicerFace> &cross_section_faces, Ref<Material> cross_section_material, uint32_t cross_section_compression = Mesh::ARRAY_COMPRESS_DEFAULT, bool merge_cross_section = false, bool keep_upper = true, bool keep_lower = true);
+
+    /**
+     * Does the same thing as the constructor above but to an existing SlicedMesh, taking
+     * the meshes for each half from the pool (if there is one) rather than creating them.
+     * If reused_mesh is given, the larger of the two halves is written into it instead
+    */
+    void create_halves(const Vector<Intersector::SplitResult> &surface_splits, const Vector<SlicerFace> &cross_section_faces, Ref<Material> cross_section_material, uint32_t cross_section_compression, bool merge_cross_section, bool keep_upper, bool keep_lower, MeshPool *pool, const Ref<ArrayMesh> &reused_mesh);
+
+    /**
+     * Like create_halves but for halves (upper first) that have already been packed, along
+     * with their cross section
+    */
+    void write_halves(const Vector<Intersector::SplitResult> &surface_splits, const PackedHalf halves[2], const SurfaceFiller *cross_section, Ref<Material> cross_section_material, bool keep_upper, bool keep_lower, MeshPool *pool, const Ref<ArrayMesh> &reused_mesh);
 
     SlicedMesh() {}
 };
 
+/**
+ * Finds the split whose surface the cross section can be merged into for the given half,
+ * or -1 if there isn't one. Skinned surfaces are never merged into
+*/
+int find_merge_target(const Vector<Intersector::SplitResult> &surface_splits, const Ref<Material> cross_section_material, bool is_upper);
+
+/**
+ * Packs one split's faces for the given half, merging in the cross section if any faces
+ * for it are given. Returns NULL if the split left no faces in the half
+*/
+SurfaceFiller *pack_half_surface(const Intersector::SplitResult &split, const Vector<SlicerFace> &merged_cross_section_faces, bool is_upper);
+
+/**
+ * Packs the cross section faces into a vertex buffer that both halves can share
+ * (see create_cross_section_surface). Returns NULL if there are no faces
+*/
+SurfaceFiller *pack_cross_section(const Vector<SlicerFace> &faces, uint32_t compression);
+
+/**
+ * Writes the packed cross section into the mesh at surface_idx, wound to face out of the
+ * upper or lower half. Returns false if there was no cross section to write
+*/
+bool create_cross_section_surface(const SurfaceFiller *cross_section, const Ref<Material> material, ArrayMesh &mesh, int surface_idx, bool is_upper);
+
 #endif // SLICED_MESH_H
@@ -1,39 +1,426 @@
 #include "slicer.h"
+#include "core/os/os.h"
+#include "core/set.h"
 #include "utils/slicer_face.h"
 #include "utils/intersector.h"
 #include "utils/triangulator.h"
+#include "utils/cross_section.h"
+#include "utils/surface_filler.h"
+#include "utils/parallel.h"
+#include "utils/task_graph.h"
+#include "utils/worker_pool.h"
+#include "utils/slice_profiler.h"
+#include "servers/visual_server.h"
 
-Ref<SlicedMesh> Slicer::slice_by_plane(const Ref<Mesh> mesh, const Plane plane, const Ref<Material> cross_section_material) {
+// All of the ARRAY_COMPRESS_* flags a surface's format can carry
+static const uint32_t COMPRESSION_MASK = Mesh::ARRAY_COMPRESS_VERTEX | Mesh::ARRAY_COMPRESS_NORMAL | Mesh::ARRAY_COMPRESS_TANGENT |
+    Mesh::ARRAY_COMPRESS_COLOR | Mesh::ARRAY_COMPRESS_TEX_UV | Mesh::ARRAY_COMPRESS_TEX_UV2 | Mesh::ARRAY_COMPRESS_BONES |
+    Mesh::ARRAY_COMPRESS_WEIGHTS | Mesh::ARRAY_COMPRESS_INDEX;
+
+/**
+ * Whether the generated surfaces can point back into the given surface's vertex buffer
+*/
+bool can_share_vertex_buffer(const Mesh &mesh, int surface_idx) {
+    return mesh.surface_get_primitive_type(surface_idx) == Mesh::PRIMITIVE_TRIANGLES &&
+        !(mesh.surface_get_format(surface_idx) & Mesh::ARRAY_FLAG_USE_2D_VERTICES) &&
+        mesh.get_rid().is_valid();
+}
+
+/**
+ * Packs the vertexes that were created by a cut onto the end of a split result's shared vertex
+ * buffer and points the faces that use them at their new index
+*/
+void append_cut_vertexes(Intersector::SplitResult &results) {
+    Vector<SlicerFace> *face_sets[2] = { &results.upper_faces, &results.lower_faces };
+
+    int cut_vertex_count = 0;
+    for (int i = 0; i < 2; i++) {
+        const SlicerFace *faces_reader = face_sets[i]->ptr();
+        for (int j = 0; j < face_sets[i]->size(); j++) {
+            for (int k = 0; k < 3; k++) {
+                if (faces_reader[j].source_index[k] < 0) {
+                    cut_vertex_count++;
+                }
+            }
+        }
+    }
+
+    if (cut_vertex_count == 0) {
+        return;
+    }
+
+    SurfaceFiller filler(results.shared_format, results.shared_vertex_array, results.shared_vertex_count, 0);
+
+    // Let go of our own reference first so that, if nobody else is holding on
+    // to the buffer, it can be grown without having to copy it
+    results.shared_vertex_array = PoolVector<uint8_t>();
+
+    int next_vertex = results.shared_vertex_count;
+    filler.resize_vertexes(next_vertex + cut_vertex_count);
+
+    for (int i = 0; i < 2; i++) {
+        SlicerFace *faces_writer = face_sets[i]->ptrw();
+        for (int j = 0; j < face_sets[i]->size(); j++) {
+            for (int k = 0; k < 3; k++) {
+                if (faces_writer[j].source_index[k] < 0) {
+                    filler.fill_vertex(faces_writer[j], k, next_vertex);
+                    faces_writer[j].source_index[k] = next_vertex++;
+                }
+            }
+        }
+    }
+
+    results.shared_vertex_array = filler.get_vertex_array();
+    results.shared_vertex_count = next_vertex;
+}
+
+/**
+ * Runs every face through the intersector, using the axis aligned version when we can
+*/
+void split_faces(const Vector<SlicerFace> &faces, const Plane &plane, const Intersector::AxisPlane *axis_plane, Intersector::SplitResult &results) {
+    const SlicerFace *faces_reader = faces.ptr();
+
+    if (axis_plane) {
+        for (int i = 0; i < faces.size(); i++) {
+            Intersector::split_face_by_plane(*axis_plane, faces_reader[i], results);
+        }
+    } else {
+        for (int i = 0; i < faces.size(); i++) {
+            Intersector::split_face_by_plane(plane, faces_reader[i], results);
+        }
+    }
+}
+
+/**
+ * What the mesh goes by in the profiler. Working it out isn't free so
+ * nobody bothers unless somebody's actually listening
+*/
+String get_profile_name(const Ref<Mesh> &mesh) {
+    SliceProfiler *profiler = SliceProfiler::get_singleton();
+    if (!profiler || !profiler->is_active()) {
+        return String();
+    }
+
+    if (mesh->get_name() != "") {
+        return mesh->get_name();
+    }
+    if (mesh->get_path() != "") {
+        return mesh->get_path();
+    }
+    return mesh->get_class();
+}
+
+/**
+ * Reads the surface's faces out of the mesh, as the parse stage
+*/
+Vector<SlicerFace> parse_surface(const Ref<Mesh> &mesh, int surface_idx, const String &mesh_name) {
+    SliceProfileScope scope("parse", mesh_name, surface_idx);
+    Vector<SlicerFace> faces = SlicerFace::faces_from_surface(**mesh, surface_idx);
+    scope.set_triangles(faces.size());
+    return faces;
+}
+
+/**
+ * Moves a plane, given by a position and normal in global space, into the
+ * local space of a mesh with the given transform
+*/
+Plane to_local_plane(const Transform &mesh_transform, const Vector3 position, const Vector3 normal) {
+    Vector3 origin = position - mesh_transform.origin;
+    real_t dist = normal.dot(origin);
+    Vector3 adjusted_normal = mesh_transform.basis.xform_inv(normal);
+
+    return Plane(adjusted_normal, dist);
+}
+
+/**
+ * A MeshInstance being cut by slice_scene. The cut itself happens on a worker
+ * thread, while anything that needs to go through the VisualServer doesn't
+*/
+struct SceneSliceTask {
+    MeshInstance *instance;
+    String mesh_name;
+    Plane plane;
+    Vector<SourceSurface> sources;
+
+    bool was_cut;
+    Vector<Intersector::SplitResult> split_results;
+    Vector<SlicerFace> cross_section_faces;
+};
+
+struct SceneSliceJob {
+    SceneSliceTask *tasks;
+    Rect2 uv_rect;
+    bool keep_upper;
+    bool keep_lower;
+};
+
+void slice_scene_task(void *userdata, int idx) {
+    SceneSliceJob &job = *(SceneSliceJob *)userdata;
+    SceneSliceTask &task = job.tasks[idx];
+
+    Intersector::AxisPlane axis_plane;
+    bool is_axis_aligned = Intersector::AxisPlane::from_plane(task.plane, axis_plane);
+    Plane plane = is_axis_aligned ? axis_plane.to_plane() : task.plane;
+
+    Vector<Vector3> intersection_points;
+    task.split_results.resize(task.sources.size());
+    Intersector::SplitResult *split_results_writer = task.split_results.ptrw();
+
+    for (int i = 0; i < task.sources.size(); i++) {
+        Intersector::SplitResult &results = split_results_writer[i];
+        results.material = task.sources[i].material;
+        results.compression = task.sources[i].compression;
+        results.keep_upper = job.keep_upper;
+        results.keep_lower = job.keep_lower;
+
+        SliceProfileScope scope("split", task.mesh_name, i);
+        scope.set_triangles(task.sources[i].faces.size());
+        split_faces(task.sources[i].faces, plane, is_axis_aligned ? &axis_plane : NULL, results);
+
+        intersection_points.append_array(results.intersection_points);
+        results.intersection_points.resize(0);
+    }
+
+    task.was_cut = intersection_points.size() > 0;
+    if (task.was_cut) {
+        SliceProfileScope scope("cap", task.mesh_name);
+        task.cross_section_faces = Triangulator::monotone_chain(intersection_points, plane.normal, job.uv_rect);
+        scope.set_triangles(task.cross_section_faces.size());
+    }
+}
+
+/**
+ * A surface being cut by slice_in_stages, along with whatever it was
+ * decomposed into ahead of time
+*/
+struct StagedSurface {
+    Vector<SlicerFace> faces;
+    const FaceBVH *bvh;
+    const ProjectionIndex *projection_index;
+
+    // If the plane passed through this surface then there's definitely
+    // a cut, and its halves can be packed without waiting on the others
+    bool was_cut;
+};
+
+struct StagedSlice {
+    String mesh_name;
+    Plane plane;
+    const Intersector::AxisPlane *axis_plane;
+    Rect2 uv_rect;
+    Ref<Material> cross_section_material;
+    uint32_t cross_section_compression;
+    bool merge_cross_section;
+
+    int surface_count;
+    StagedSurface *surfaces;
+    Vector<Intersector::SplitResult> split_results;
+    Intersector::SplitResult *splits;
+
+    bool was_cut;
+    Vector<SlicerFace> cross_section_faces;
+    SurfaceFiller *cross_section;
+
+    // Upper then lower, with a packed surface for each split. Null for halves that aren't kept
+    PackedHalf halves[2];
+    SurfaceFiller **packed[2];
+
+    // Packing of surfaces the plane missed, which waits until we know there's a cut at all
+    Vector<int> deferred;
+};
+
+void split_stage(void *userdata, int idx) {
+    StagedSlice &slice = *(StagedSlice *)userdata;
+    StagedSurface &surface = slice.surfaces[idx];
+    Intersector::SplitResult &results = slice.splits[idx];
+
+    SliceProfileScope scope("split", slice.mesh_name, idx);
+    scope.set_triangles(surface.faces.size());
+
+    if (surface.projection_index && surface.projection_index->split_by_plane(slice.plane, surface.faces, results)) {
+        // The plane was facing one of the indexed directions so we're already done
+    } else if (surface.bvh) {
+        surface.bvh->split_by_plane(slice.plane, surface.faces, results);
+    } else {
+        split_faces(surface.faces, slice.plane, slice.axis_plane, results);
+    }
+
+    surface.was_cut = results.intersection_points.size() > 0;
+}
+
+void cross_section_stage(void *userdata, int idx) {
+    StagedSlice &slice = *(StagedSlice *)userdata;
+    SliceProfileScope scope("cap", slice.mesh_name);
+
+    // The upper and lower meshes will share the same intersection points
+    Vector<Vector3> intersection_points;
+    for (int i = 0; i < slice.surface_count; i++) {
+        intersection_points.append_array(slice.splits[i].intersection_points);
+        slice.splits[i].intersection_points.resize(0);
+    }
+
+    slice.was_cut = intersection_points.size() > 0;
+    if (!slice.was_cut) {
+        return;
+    }
+
+    slice.cross_section_faces = Triangulator::monotone_chain(intersection_points, slice.plane.normal, slice.uv_rect);
+    scope.set_triangles(slice.cross_section_faces.size());
+    slice.cross_section = pack_cross_section(slice.cross_section_faces, slice.cross_section_compression);
+
+    // Packing only waits on us when there's something to merge
+    if (slice.merge_cross_section && slice.cross_section) {
+        for (int i = 0; i < 2; i++) {
+            if (slice.packed[i]) {
+                slice.halves[i].merge_target = find_merge_target(slice.split_results, slice.cross_section_material, i == 0);
+            }
+        }
+    }
+}
+
+/**
+ * Packs one surface of one half, with idx running through the surfaces of the upper half and then the lower
+*/
+void pack_surface_half(StagedSlice &slice, int idx) {
+    int half = idx / slice.surface_count;
+    int surface_idx = idx % slice.surface_count;
+    bool is_merge_target = surface_idx == slice.halves[half].merge_target;
+
+    const Intersector::SplitResult &results = slice.splits[surface_idx];
+    SliceProfileScope scope("build", slice.mesh_name, surface_idx);
+    scope.set_triangles(half == 0 ? results.upper_faces.size() : results.lower_faces.size());
+
+    slice.packed[half][surface_idx] = pack_half_surface(slice.splits[surface_idx], is_merge_target ? slice.cross_section_faces : Vector<SlicerFace>(), half == 0);
+}
+
+void pack_stage(void *userdata, int idx) {
+    StagedSlice &slice = *(StagedSlice *)userdata;
+    if (slice.surfaces[idx % slice.surface_count].was_cut) {
+        pack_surface_half(slice, idx);
+    }
+}
+
+void deferred_pack_stage(void *userdata, int idx) {
+    StagedSlice &slice = *(StagedSlice *)userdata;
+    pack_surface_half(slice, slice.deferred[idx]);
+}
+
+const Slicer::CachedSurface &Slicer::get_cached_surface(const Ref<Mesh> &mesh, int surface_idx) {
+    ObjectID id = mesh->get_instance_id();
+
+    Map<ObjectID, Vector<CachedSurface> >::Element *element = decomposition_cache.find(id);
+    if (!element) {
+        // Take the chance to drop anything belonging to meshes that have since been freed
+        Map<ObjectID, Vector<CachedSurface> >::Element *cached = decomposition_cache.front();
+        while (cached) {
+            Map<ObjectID, Vector<CachedSurface> >::Element *next = cached->next();
+            if (!ObjectDB::get_instance(cached->key())) {
+                decomposition_cache.erase(cached->key());
+            }
+            cached = next;
+        }
+
+        element = decomposition_cache.insert(id, Vector<CachedSurface>());
+    }
+
+    Vector<CachedSurface> &surfaces = element->value();
+    if (surfaces.size() != mesh->get_surface_count()) {
+        surfaces.clear();
+        surfaces.resize(mesh->get_surface_count());
+    }
+
+    CachedSurface &surface = surfaces.ptrw()[surface_idx];
+    uint32_t format = mesh->surface_get_format(surface_idx);
+    int array_len = mesh->surface_get_array_len(surface_idx);
+    int index_array_len = mesh->surface_get_array_index_len(surface_idx);
+
+    if (surface.format != format || surface.array_len != array_len || surface.index_array_len != index_array_len) {
+        surface.format = format;
+        surface.array_len = array_len;
+        surface.index_array_len = index_array_len;
+        surface.faces = parse_surface(mesh, surface_idx, get_profile_name(mesh));
+        surface.bvh = FaceBVH();
+
+        surface.projection_index = ProjectionIndex();
+
+        if (use_bvh) {
+            surface.bvh.build(surface.faces);
+        }
+
+        if (indexed_directions.size() > 0) {
+            surface.projection_index.build(surface.faces, indexed_directions);
+        }
+    }
+
+    return surface;
+}
+
+void Slicer::set_compression_flags(int p_compression_flags) {
+    compression_flags = p_compression_flags & COMPRESSION_MASK;
+}
+
+Ref<SlicedMesh> Slicer::slice_by_plane(const Ref<Mesh> mesh, const Plane p_plane, const Ref<Material> cross_section_material) {
     // TODO - This function is a little heavy. Maybe we should break it up
     if (mesh.is_null()) {
         return Ref<SlicedMesh>();
     }
 
-    PoolVector<Intersector::SplitResult> split_results;
+    // Planes that are (near enough) axis aligned get snapped so that they're exactly
+    // aligned, which lets every face be split without taking any dot products
+    Intersector::AxisPlane axis_plane;
+    bool is_axis_aligned = Intersector::AxisPlane::from_plane(p_plane, axis_plane);
+    Plane plane = is_axis_aligned ? axis_plane.to_plane() : p_plane;
+
+    String mesh_name = get_profile_name(mesh);
+    SliceProfileScope scope("slice", mesh_name, -1, false);
+
+    // Sharing vertex buffers means going back to the source mesh between stages, which
+    // has to happen on this thread, so only copied buffers get their stages overlapped
+    if (vertex_buffer_mode == VERTEX_BUFFER_COPY) {
+        return slice_in_stages(mesh, mesh_name, plane, is_axis_aligned ? &axis_plane : NULL, cross_section_material);
+    }
+
+    Vector<Intersector::SplitResult> split_results;
     split_results.resize(mesh->get_surface_count());
-    PoolVector<Intersector::SplitResult>::Write split_results_writer = split_results.write();
+    Intersector::SplitResult *split_results_writer = split_results.ptrw();
 
     // The upper and lower meshes will share the same intersection points
-    PoolVector<Vector3> intersection_points;
+    Vector<Vector3> intersection_points;
 
     for (int i = 0; i < mesh->get_surface_count(); i++) {
         Intersector::SplitResult results = split_results[i];
 
         results.material = mesh->surface_get_material(i);
-        PoolVector<SlicerFace> faces = SlicerFace::faces_from_surface(**mesh, i);
-        PoolVector<SlicerFace>::Read faces_reader = faces.read();
+        results.compression = inherit_compression ? mesh->surface_get_format(i) & COMPRESSION_MASK : compression_flags;
+        results.keep_upper = keep != KEEP_LOWER;
+        results.keep_lower = keep != KEEP_UPPER;
 
-        for (int j = 0; j < faces.size(); j++) {
-            Intersector::split_face_by_plane(plane, faces_reader[j], results);
+        if (vertex_buffer_mode != VERTEX_BUFFER_COPY && can_share_vertex_buffer(**mesh, i)) {
+            results.shared_vertex_array = VisualServer::get_singleton()->mesh_surface_get_array(mesh->get_rid(), i);
+            results.shared_format = mesh->surface_get_format(i);
+            results.shared_vertex_count = mesh->surface_get_array_len(i);
         }
 
-        int ip_size = intersection_points.size();
-        intersection_points.resize(ip_size + results.intersection_points.size());
-        PoolVector<Vector3>::Write ip_writer = intersection_points.write();
-        for (int j = 0; j < results.intersection_points.size(); j ++) {
-            ip_writer[ip_size + j] = results.intersection_points[j];
+        if (cache_decomposition) {
+            const CachedSurface &cached = get_cached_surface(mesh, i);
+            SliceProfileScope split_scope("split", mesh_name, i);
+            split_scope.set_triangles(cached.faces.size());
+
+            if (cached.projection_index.is_built() && cached.projection_index.split_by_plane(plane, cached.faces, results)) {
+                // The plane was facing one of the indexed directions so we're already done
+            } else if (cached.bvh.is_built()) {
+                cached.bvh.split_by_plane(plane, cached.faces, results);
+            } else {
+                split_faces(cached.faces, plane, is_axis_aligned ? &axis_plane : NULL, results);
+            }
+        } else {
+            Vector<SlicerFace> faces = parse_surface(mesh, i, mesh_name);
+            SliceProfileScope split_scope("split", mesh_name, i);
+            split_scope.set_triangles(faces.size());
+            split_faces(faces, plane, is_axis_aligned ? &axis_plane : NULL, results);
         }
-        ip_writer.release();
+
+        intersection_points.append_array(results.intersection_points);
         results.intersection_points.resize(0);
 
         split_results_writer[i] = results;
@@ -47,10 +434,443 @@ Ref<SlicedMesh> Slicer::slice_by_plane(const Ref<Mesh> mesh, const Plane plane,
         return Ref<SlicedMesh>();
     }
 
-    PoolVector<SlicerFace> cross_section_faces = Triangulator::monotone_chain(intersection_points, plane.normal);
+    if (vertex_buffer_mode == VERTEX_BUFFER_CONSUME) {
+        // Now that we know a cut is actually going to happen we can clear out the source
+        // mesh, leaving the split results as the only owners of its vertex buffers
+        Ref<ArrayMesh> array_mesh = mesh;
+        if (array_mesh.is_valid()) {
+            while (array_mesh->get_surface_count() > 0) {
+                array_mesh->surface_remove(0);
+            }
+            decomposition_cache.erase(array_mesh->get_instance_id());
+        }
+    }
+
+    if (vertex_buffer_mode != VERTEX_BUFFER_COPY) {
+        for (int i = 0; i < split_results.size(); i++) {
+            if (split_results_writer[i].shared_vertex_count > 0) {
+                SliceProfileScope build_scope("build", mesh_name, i);
+                append_cut_vertexes(split_results_writer[i]);
+            }
+        }
+    }
+
+    Vector<SlicerFace> cross_section_faces;
+    {
+        SliceProfileScope cap_scope("cap", mesh_name);
+        cross_section_faces = Triangulator::monotone_chain(intersection_points, plane.normal, cross_section_uv_rect);
+        cap_scope.set_triangles(cross_section_faces.size());
+    }
+
+    // The cross section doesn't have a source surface of its own so, when inheriting, just
+    // follow whatever the first surface is doing
+    uint32_t cross_section_compression = inherit_compression ? split_results[0].compression : compression_flags;
+
+    return create_sliced_mesh(mesh, split_results, cross_section_faces, cross_section_material, cross_section_compression);
+}
+
+Ref<SlicedMesh> Slicer::slice_in_stages(const Ref<Mesh> &mesh, const String &mesh_name, const Plane &plane, const Intersector::AxisPlane *axis_plane, const Ref<Material> &cross_section_material) {
+    int surface_count = mesh->get_surface_count();
+
+    StagedSlice slice;
+    slice.mesh_name = mesh_name;
+    slice.plane = plane;
+    slice.axis_plane = axis_plane;
+    slice.uv_rect = cross_section_uv_rect;
+    slice.cross_section_material = cross_section_material;
+    slice.merge_cross_section = merge_cross_section;
+    slice.surface_count = surface_count;
+    slice.was_cut = false;
+    slice.cross_section = NULL;
+
+    slice.split_results.resize(surface_count);
+    Intersector::SplitResult *split_results_writer = slice.split_results.ptrw();
+    slice.splits = split_results_writer;
+
+    // Anything that goes through the mesh (and so the VisualServer) happens up front, on this thread
+    Vector<StagedSurface> surfaces;
+    surfaces.resize(surface_count);
+    for (int i = 0; i < surface_count; i++) {
+        Intersector::SplitResult &results = slice.splits[i];
+        results.material = mesh->surface_get_material(i);
+        results.compression = inherit_compression ? mesh->surface_get_format(i) & COMPRESSION_MASK : compression_flags;
+        results.keep_upper = keep != KEEP_LOWER;
+        results.keep_lower = keep != KEEP_UPPER;
+
+        StagedSurface &surface = surfaces.ptrw()[i];
+        surface.bvh = NULL;
+        surface.projection_index = NULL;
+        surface.was_cut = false;
+
+        if (cache_decomposition) {
+            const CachedSurface &cached = get_cached_surface(mesh, i);
+            surface.faces = cached.faces;
+            surface.bvh = cached.bvh.is_built() ? &cached.bvh : NULL;
+            surface.projection_index = cached.projection_index.is_built() ? &cached.projection_index : NULL;
+        } else {
+            surface.faces = parse_surface(mesh, i, mesh_name);
+        }
+    }
+    slice.surfaces = surfaces.ptrw();
+
+    // The cross section doesn't have a source surface of its own so, when inheriting, just
+    // follow whatever the first surface is doing
+    slice.cross_section_compression = inherit_compression && surface_count > 0 ? slice.splits[0].compression : compression_flags;
+
+    bool keep_halves[2] = { keep != KEEP_LOWER, keep != KEEP_UPPER };
+    for (int i = 0; i < 2; i++) {
+        slice.packed[i] = NULL;
+        if (keep_halves[i]) {
+            slice.halves[i].surfaces.resize(surface_count);
+            slice.packed[i] = slice.halves[i].surfaces.ptrw();
+            for (int j = 0; j < surface_count; j++) {
+                slice.packed[i][j] = NULL;
+            }
+        }
+    }
+
+    TaskGraph graph;
+    int cross_section_task = graph.add_task(cross_section_stage, &slice);
+    for (int i = 0; i < surface_count; i++) {
+        int split_task = graph.add_task(split_stage, &slice, i);
+        graph.add_dependency(cross_section_task, split_task);
+
+        for (int j = 0; j < 2; j++) {
+            if (!keep_halves[j]) {
+                continue;
+            }
+
+            int pack_task = graph.add_task(pack_stage, &slice, j * surface_count + i);
+            graph.add_dependency(pack_task, split_task);
+            if (merge_cross_section) {
+                graph.add_dependency(pack_task, cross_section_task);
+            }
+        }
+    }
+    graph.run();
+
+    if (!slice.was_cut) {
+        return Ref<SlicedMesh>();
+    }
+
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < surface_count; j++) {
+            if (keep_halves[i] && !slice.surfaces[j].was_cut) {
+                slice.deferred.push_back(i * surface_count + j);
+            }
+        }
+    }
+    Parallel::for_each(slice.deferred.size(), OS::get_singleton()->get_processor_count(), deferred_pack_stage, &slice);
 
-    SlicedMesh *sliced_mesh = memnew(SlicedMesh(split_results, cross_section_faces, cross_section_material));
-    return Ref<SlicedMesh>(sliced_mesh);
+    Ref<SlicedMesh> sliced_mesh = create_sliced_mesh(mesh, slice.split_results, slice.cross_section_faces, cross_section_material, slice.cross_section_compression, slice.halves, slice.cross_section);
+
+    if (slice.cross_section) {
+        memdelete(slice.cross_section);
+    }
+
+    return sliced_mesh;
+}
+
+Ref<SlicedMesh> Slicer::create_sliced_mesh(const Ref<Mesh> &source, const Vector<Intersector::SplitResult> &split_results, const Vector<SlicerFace> &cross_section_faces, const Ref<Material> &cross_section_material, uint32_t cross_section_compression, const PackedHalf *packed_halves, const SurfaceFiller *packed_cross_section, bool can_reuse_source) {
+    SliceProfileScope scope("build", get_profile_name(source));
+    MeshPool *pool = get_mesh_pool();
+
+    // Surfaces can't be added to a mesh with blend shapes without blend shapes of their own
+    Ref<ArrayMesh> reused_mesh;
+    if (update_in_place && can_reuse_source) {
+        reused_mesh = source;
+        if (reused_mesh.is_valid() && reused_mesh->get_blend_shape_count() > 0) {
+            reused_mesh = Ref<ArrayMesh>();
+        }
+    }
+
+    if (!pool && reused_mesh.is_null() && !packed_halves) {
+        return Ref<SlicedMesh>(memnew(SlicedMesh(split_results, cross_section_faces, cross_section_material, cross_section_compression, merge_cross_section, keep != KEEP_LOWER, keep != KEEP_UPPER)));
+    }
+
+    Ref<SlicedMesh> sliced_mesh = pool ? pool->take_sliced_mesh() : Ref<SlicedMesh>(memnew(SlicedMesh));
+    if (packed_halves) {
+        sliced_mesh->write_halves(split_results, packed_halves, packed_cross_section, cross_section_material, keep != KEEP_LOWER, keep != KEEP_UPPER, pool, reused_mesh);
+    } else {
+        sliced_mesh->create_halves(split_results, cross_section_faces, cross_section_material, cross_section_compression, merge_cross_section, keep != KEEP_LOWER, keep != KEEP_UPPER, pool, reused_mesh);
+    }
+
+    if (reused_mesh.is_valid()) {
+        // Whatever we had cached for the mesh no longer matches it, and surfaces updated
+        // in place keep their size and format so the cache wouldn't notice on its own
+        decomposition_cache.erase(reused_mesh->get_instance_id());
+    }
+
+    return sliced_mesh;
+}
+
+Ref<SlicedArrays> Slicer::slice_arrays(const Array &arrays, const Plane p_plane) {
+    Vector<SlicerFace> faces = SlicerFace::faces_from_arrays(arrays);
+    if (faces.size() == 0) {
+        return Ref<SlicedArrays>();
+    }
+
+    Intersector::AxisPlane axis_plane;
+    bool is_axis_aligned = Intersector::AxisPlane::from_plane(p_plane, axis_plane);
+    Plane plane = is_axis_aligned ? axis_plane.to_plane() : p_plane;
+
+    Intersector::SplitResult results;
+    results.keep_upper = keep != KEEP_LOWER;
+    results.keep_lower = keep != KEEP_UPPER;
+    split_faces(faces, plane, is_axis_aligned ? &axis_plane : NULL, results);
+
+    if (results.intersection_points.size() == 0) {
+        return Ref<SlicedArrays>();
+    }
+
+    Vector<SlicerFace> cross_section_faces = Triangulator::monotone_chain(results.intersection_points, plane.normal, cross_section_uv_rect);
+    return Ref<SlicedArrays>(memnew(SlicedArrays(results, cross_section_faces)));
+}
+
+Vector<SourceSurface> Slicer::get_source_surfaces(const Ref<Mesh> &mesh) {
+    String mesh_name = get_profile_name(mesh);
+    Vector<SourceSurface> sources;
+    sources.resize(mesh->get_surface_count());
+
+    for (int i = 0; i < mesh->get_surface_count(); i++) {
+        SourceSurface &source = sources.ptrw()[i];
+        source.faces = cache_decomposition ? get_cached_surface(mesh, i).faces : parse_surface(mesh, i, mesh_name);
+        source.material = mesh->surface_get_material(i);
+        source.compression = inherit_compression ? mesh->surface_get_format(i) & COMPRESSION_MASK : compression_flags;
+    }
+
+    return sources;
+}
+
+Array Slicer::create_cell_meshes(const Vector<CellMesh> &cells, const Vector<SourceSurface> &sources, const Ref<Material> &cross_section_material) {
+    uint32_t cross_section_compression = get_cross_section_compression(sources);
+
+    Array meshes;
+    meshes.resize(cells.size());
+    for (int i = 0; i < cells.size(); i++) {
+        if (!cells[i].is_empty()) {
+            meshes[i] = cells[i].create_mesh(sources, cross_section_material, cross_section_compression, get_mesh_pool());
+        }
+    }
+
+    return meshes;
+}
+
+Array Slicer::create_diced_meshes(const Vector<CellMesh> &cells, const Dicer::Grid &grid, bool is_grid, const Vector<SourceSurface> &sources, const Ref<Material> &cross_section_material) {
+    uint32_t cross_section_compression = get_cross_section_compression(sources);
+
+    Array meshes;
+    for (int i = 0; i < cells.size(); i++) {
+        if (cells[i].is_empty()) {
+            continue;
+        }
+
+        Dictionary result;
+        result["mesh"] = cells[i].create_mesh(sources, cross_section_material, cross_section_compression, get_mesh_pool());
+        if (is_grid) {
+            result["cell"] = Vector3(grid.get_slab(i, 0), grid.get_slab(i, 1), grid.get_slab(i, 2));
+        } else {
+            result["index"] = grid.get_slab(i, 0);
+        }
+        meshes.push_back(result);
+    }
+
+    return meshes;
+}
+
+Array Slicer::dice(const Ref<Mesh> mesh, const Vector3 direction, real_t spacing, const Ref<Material> cross_section_material) {
+    ERR_FAIL_COND_V(direction == Vector3(), Array());
+    ERR_FAIL_COND_V(spacing <= 0, Array());
+    if (mesh.is_null()) {
+        return Array();
+    }
+
+    Vector<Dicer::Axis> axes;
+    axes.push_back(Dicer::Axis(direction, spacing));
+
+    SliceProfileScope scope("dice", get_profile_name(mesh), -1, false);
+    Vector<SourceSurface> sources = get_source_surfaces(mesh);
+    Dicer::Grid grid;
+    Vector<CellMesh> cells = Dicer::dice(sources, axes, cross_section_uv_rect, &grid);
+    return create_diced_meshes(cells, grid, false, sources, cross_section_material);
+}
+
+Array Slicer::dice_grid(const Ref<Mesh> mesh, const Vector3 cell_size, const Ref<Material> cross_section_material) {
+    ERR_FAIL_COND_V(cell_size.x <= 0 || cell_size.y <= 0 || cell_size.z <= 0, Array());
+    if (mesh.is_null()) {
+        return Array();
+    }
+
+    Vector<Dicer::Axis> axes;
+    axes.push_back(Dicer::Axis(Vector3(1, 0, 0), cell_size.x));
+    axes.push_back(Dicer::Axis(Vector3(0, 1, 0), cell_size.y));
+    axes.push_back(Dicer::Axis(Vector3(0, 0, 1), cell_size.z));
+
+    SliceProfileScope scope("dice_grid", get_profile_name(mesh), -1, false);
+    Vector<SourceSurface> sources = get_source_surfaces(mesh);
+    Dicer::Grid grid;
+    Vector<CellMesh> cells = Dicer::dice(sources, axes, cross_section_uv_rect, &grid);
+    return create_diced_meshes(cells, grid, true, sources, cross_section_material);
+}
+
+Ref<SlicedMesh> Slicer::clip_to_convex(const Ref<Mesh> mesh, const Array &planes, const Ref<Material> cross_section_material, bool keep_outside) {
+    if (mesh.is_null()) {
+        return Ref<SlicedMesh>();
+    }
+
+    Vector<Plane> clip_planes;
+    for (int i = 0; i < planes.size(); i++) {
+        ERR_FAIL_COND_V(planes[i].get_type() != Variant::PLANE, Ref<SlicedMesh>());
+        Plane plane = planes[i];
+        clip_planes.push_back(plane.normalized());
+    }
+
+    SliceProfileScope scope("clip_to_convex", get_profile_name(mesh), -1, false);
+    Vector<SourceSurface> sources = get_source_surfaces(mesh);
+    CellMesh inside;
+    CellMesh outside;
+    Clipper::clip_to_convex(sources, clip_planes, keep_outside, inside, outside, cross_section_uv_rect);
+
+    uint32_t cross_section_compression = get_cross_section_compression(sources);
+    Ref<Mesh> inside_mesh;
+    Ref<Mesh> outside_mesh;
+    if (!inside.is_empty()) {
+        inside_mesh = inside.create_mesh(sources, cross_section_material, cross_section_compression, get_mesh_pool());
+    }
+    if (!outside.is_empty()) {
+        outside_mesh = outside.create_mesh(sources, cross_section_material, cross_section_compression, get_mesh_pool());
+    }
+
+    if (get_mesh_pool()) {
+        Ref<SlicedMesh> sliced_mesh = mesh_pool.take_sliced_mesh();
+        sliced_mesh->upper_mesh = outside_mesh;
+        sliced_mesh->lower_mesh = inside_mesh;
+        return sliced_mesh;
+    }
+
+    return Ref<SlicedMesh>(memnew(SlicedMesh(outside_mesh, inside_mesh)));
+}
+
+Array Slicer::shatter(const Ref<Mesh> mesh, const PoolVector<Vector3> &seed_points, const Ref<Material> cross_section_material) {
+    if (mesh.is_null() || seed_points.size() == 0) {
+        return Array();
+    }
+
+    Vector<Vector3> seeds;
+    seeds.resize(seed_points.size());
+    PoolVector<Vector3>::Read seed_points_reader = seed_points.read();
+    for (int i = 0; i < seed_points.size(); i++) {
+        seeds.ptrw()[i] = seed_points_reader[i];
+    }
+
+    // The threads only ever read from the decomposition so every cell can share it.
+    // Building the meshes has to go through the VisualServer so that stays on this thread
+    SliceProfileScope scope("shatter", get_profile_name(mesh), -1, false);
+    Vector<SourceSurface> sources = get_source_surfaces(mesh);
+    Vector<CellMesh> cells = Shatterer::shatter(sources, seeds, OS::get_singleton()->get_processor_count(), cross_section_uv_rect);
+    return create_cell_meshes(cells, sources, cross_section_material);
+}
+
+Dictionary Slicer::query_cross_section(const Ref<Mesh> mesh, const Plane p_plane) {
+    ERR_FAIL_COND_V(p_plane.normal == Vector3(), Dictionary());
+    if (mesh.is_null()) {
+        return Dictionary();
+    }
+
+    // The area and the flattened loops are both measured along the normal
+    Plane plane = p_plane.normalized();
+
+    // Meshes hold on to the triangles get_faces hands out, so asking
+    // about the same mesh again doesn't have to reread its surfaces
+    Vector<CrossSection::Loop> loops = CrossSection::find_loops(mesh->get_faces(), plane);
+    if (loops.size() == 0) {
+        return Dictionary();
+    }
+
+    Vector3 u;
+    Vector3 v;
+    Triangulator::plane_basis(plane.normal, u, v);
+
+    Array loops_3d;
+    Array loops_2d;
+    real_t area = 0;
+    real_t perimeter = 0;
+    AABB bounds(loops[0].points[0], Vector3());
+
+    for (int i = 0; i < loops.size(); i++) {
+        const CrossSection::Loop &loop = loops[i];
+
+        // The loops are only turned into PoolVectors here, on their way out to the script
+        PoolVector<Vector3> points;
+        PoolVector<Vector2> flattened;
+        points.resize(loop.points.size());
+        flattened.resize(loop.points.size());
+        PoolVector<Vector3>::Write points_writer = points.write();
+        PoolVector<Vector2>::Write flattened_writer = flattened.write();
+        const Vector3 *points_reader = loop.points.ptr();
+        for (int j = 0; j < loop.points.size(); j++) {
+            points_writer[j] = points_reader[j];
+            flattened_writer[j] = Vector2(u.dot(points_reader[j]), v.dot(points_reader[j]));
+            bounds.expand_to(points_reader[j]);
+        }
+        points_writer.release();
+        flattened_writer.release();
+
+        loops_3d.push_back(points);
+        loops_2d.push_back(flattened);
+        area += loop.area(plane.normal);
+        perimeter += loop.length();
+    }
+
+    Dictionary result;
+    result["loops"] = loops_3d;
+    result["loops_2d"] = loops_2d;
+    result["area"] = area;
+    result["perimeter"] = perimeter;
+    result["bounds"] = bounds;
+    return result;
+}
+
+Ref<SliceSession> Slicer::create_session(const Ref<Mesh> mesh) {
+    if (mesh.is_null()) {
+        return Ref<SliceSession>();
+    }
+
+    Vector<SourceSurface> sources = get_source_surfaces(mesh);
+    return Ref<SliceSession>(memnew(SliceSession(sources, get_cross_section_compression(sources), cross_section_uv_rect, keep != KEEP_LOWER, keep != KEEP_UPPER)));
+}
+
+Ref<SliceJob> Slicer::create_job(const Ref<Mesh> mesh, const Plane plane, const Ref<Material> cross_section_material) {
+    if (mesh.is_null()) {
+        return Ref<SliceJob>();
+    }
+
+    Vector<Intersector::SplitResult> split_results;
+    split_results.resize(mesh->get_surface_count());
+    Intersector::SplitResult *split_results_writer = split_results.ptrw();
+
+    for (int i = 0; i < mesh->get_surface_count(); i++) {
+        Intersector::SplitResult &results = split_results_writer[i];
+        results.material = mesh->surface_get_material(i);
+        results.compression = inherit_compression ? mesh->surface_get_format(i) & COMPRESSION_MASK : compression_flags;
+        results.keep_upper = keep != KEEP_LOWER;
+        results.keep_lower = keep != KEEP_UPPER;
+    }
+
+    // With the cache on, the faces are taken from it (decomposing the mesh into it first
+    // if it isn't there yet). Otherwise reading them out of the mesh is left to the job,
+    // so that it's spread out along with everything else
+    Vector<Vector<SlicerFace> > cached_faces;
+    if (cache_decomposition) {
+        cached_faces.resize(mesh->get_surface_count());
+        for (int i = 0; i < mesh->get_surface_count(); i++) {
+            cached_faces.ptrw()[i] = get_cached_surface(mesh, i).faces;
+        }
+    }
+
+    uint32_t cross_section_compression = inherit_compression && split_results.size() > 0 ? split_results_writer[0].compression : compression_flags;
+
+    return Ref<SliceJob>(memnew(SliceJob(mesh, plane, split_results, cached_faces, cross_section_material, cross_section_compression, cross_section_uv_rect, merge_cross_section)));
 }
 
 Ref<SlicedMesh> Slicer::slice_mesh(const Ref<Mesh> mesh, const Vector3 position, const Vector3 normal, const Ref<Material> cross_section_material) {
@@ -60,15 +880,206 @@ Ref<SlicedMesh> Slicer::slice_mesh(const Ref<Mesh> mesh, const Vector3 position,
 
 Ref<SlicedMesh> Slicer::slice(const Ref<Mesh> mesh, const Transform mesh_transform, const Vector3 position, const Vector3 normal, const Ref<Material> cross_section_material) {
     // We need to reorient the plane so that it will correctly slice the mesh whose vertexes are based on the origin
-    Vector3 origin = position - mesh_transform.origin;
-    real_t dist = normal.dot(origin);
-    Vector3 adjusted_normal = mesh_transform.basis.xform_inv(normal);
+    return slice_by_plane(mesh, to_local_plane(mesh_transform, position, normal), cross_section_material);
+}
 
-    return slice_by_plane(mesh, Plane(adjusted_normal, dist), cross_section_material);
+Array Slicer::slice_scene(Node *root, const Plane p_plane, const Ref<Material> cross_section_material, uint32_t layer_mask) {
+    ERR_FAIL_NULL_V(root, Array());
+    ERR_FAIL_COND_V(p_plane.normal == Vector3(), Array());
+
+    // The plane gets moved into each instance's space through a point on it, which
+    // is only normal * d if the normal is a unit vector
+    Plane plane = p_plane.normalized();
+
+    Ref<World> world = get_world();
+    Spatial *spatial_root = Object::cast_to<Spatial>(root);
+    if (spatial_root) {
+        world = spatial_root->get_world();
+    }
+    ERR_FAIL_COND_V_MSG(world.is_null(), Array(), "The root node needs to be inside of a 3D world.");
+
+    // A convex volume made of the plane facing both ways is as thin as the plane itself, so
+    // it only lets through instances whose bounds actually straddle (or touch) the plane
+    Vector<Plane> volume;
+    volume.push_back(plane);
+    volume.push_back(-plane);
+    Vector<ObjectID> candidates = VisualServer::get_singleton()->instances_cull_convex(volume, world->get_scenario());
+
+    // The stages run on other threads, and only get passed on to the editor
+    // once something on this one ends
+    SliceProfileScope scope("slice_scene", root->get_name(), -1, false);
+
+    Vector<SceneSliceTask> tasks;
+    for (int i = 0; i < candidates.size(); i++) {
+        MeshInstance *instance = Object::cast_to<MeshInstance>(ObjectDB::get_instance(candidates[i]));
+        if (!instance || instance->get_mesh().is_null() || !(instance->get_layer_mask() & layer_mask)) {
+            continue;
+        }
+
+        if (instance != root && !root->is_a_parent_of(instance)) {
+            continue;
+        }
+
+        SceneSliceTask task;
+        task.instance = instance;
+        task.plane = to_local_plane(instance->get_global_transform(), plane.normal * plane.d, plane.normal);
+        task.mesh_name = get_profile_name(instance->get_mesh());
+        task.sources = get_source_surfaces(instance->get_mesh());
+        tasks.push_back(task);
+    }
+
+    // Instances sharing a mesh can't all be written back into it, so none of them are
+    Set<Mesh *> seen_meshes;
+    Set<Mesh *> shared_meshes;
+    for (int i = 0; i < tasks.size(); i++) {
+        Mesh *mesh = tasks[i].instance->get_mesh().ptr();
+        if (seen_meshes.has(mesh)) {
+            shared_meshes.insert(mesh);
+        }
+        seen_meshes.insert(mesh);
+    }
+
+    SceneSliceJob job;
+    job.tasks = tasks.ptrw();
+    job.uv_rect = cross_section_uv_rect;
+    job.keep_upper = keep != KEEP_LOWER;
+    job.keep_lower = keep != KEEP_UPPER;
+    Parallel::for_each(tasks.size(), OS::get_singleton()->get_processor_count(), slice_scene_task, &job);
+
+    Array results;
+    for (int i = 0; i < tasks.size(); i++) {
+        const SceneSliceTask &task = tasks[i];
+        if (!task.was_cut) {
+            continue;
+        }
+
+        Ref<Mesh> mesh = task.instance->get_mesh();
+        bool can_reuse_mesh = !shared_meshes.has(mesh.ptr());
+        Ref<SlicedMesh> sliced_mesh = create_sliced_mesh(mesh, task.split_results, task.cross_section_faces, cross_section_material, get_cross_section_compression(task.sources), NULL, NULL, can_reuse_mesh);
+
+        Dictionary result;
+        result["instance"] = task.instance;
+        result["sliced_mesh"] = sliced_mesh;
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+Dictionary Slicer::get_worker_pool_stats() const {
+    // Asking how the pool is doing shouldn't be what starts it up
+    Dictionary result;
+    WorkerPool *pool = WorkerPool::get_singleton(false);
+    if (!pool) {
+        return result;
+    }
+
+    WorkerPool::Stats stats = pool->get_stats();
+    result["thread_count"] = stats.thread_count;
+    result["batches"] = stats.batches;
+    result["tasks"] = stats.tasks;
+    result["steals"] = stats.steals;
+    result["busy_usec"] = stats.busy_usec;
+    result["elapsed_usec"] = stats.elapsed_usec;
+
+    // The threads that handed the work over pitch in with it too, so a busy
+    // pool can come out a little over 1
+    real_t elapsed = stats.elapsed_usec > 0 ? stats.elapsed_usec / 1000000.0 : 0;
+    result["tasks_per_second"] = elapsed > 0 ? stats.tasks / elapsed : 0;
+    result["utilisation"] = elapsed > 0 ? (stats.busy_usec / 1000000.0) / (elapsed * MAX(stats.thread_count, 1)) : 0;
+    return result;
+}
+
+void Slicer::reset_worker_pool_stats() {
+    WorkerPool *pool = WorkerPool::get_singleton(false);
+    if (pool) {
+        pool->reset_stats();
+    }
+}
+
+Error Slicer::start_trace(const String &path) {
+    SliceProfiler *profiler = SliceProfiler::get_singleton();
+    ERR_FAIL_NULL_V(profiler, ERR_UNAVAILABLE);
+    return profiler->start_trace(path);
+}
+
+Error Slicer::stop_trace() {
+    SliceProfiler *profiler = SliceProfiler::get_singleton();
+    ERR_FAIL_NULL_V(profiler, ERR_UNAVAILABLE);
+    return profiler->stop_trace();
 }
 
 void Slicer::_bind_methods() {
     ClassDB::bind_method(D_METHOD("slice_by_plane", "mesh", "plane", "cross_section_material"), &Slicer::slice_by_plane, Variant::NIL);
+    ClassDB::bind_method(D_METHOD("slice_arrays", "arrays", "plane"), &Slicer::slice_arrays);
+    ClassDB::bind_method(D_METHOD("query_cross_section", "mesh", "plane"), &Slicer::query_cross_section);
+    ClassDB::bind_method(D_METHOD("create_session", "mesh"), &Slicer::create_session);
+    ClassDB::bind_method(D_METHOD("create_job", "mesh", "plane", "cross_section_material"), &Slicer::create_job, Variant::NIL);
     ClassDB::bind_method(D_METHOD("slice_mesh", "mesh", "position", "normal", "cross_section_material"), &Slicer::slice_mesh, Variant::NIL);
     ClassDB::bind_method(D_METHOD("slice", "mesh_instance", "mesh_transform", "position", "normal", "cross_section_material"), &Slicer::slice, Variant::NIL);
+    ClassDB::bind_method(D_METHOD("slice_scene", "root", "plane", "cross_section_material", "layer_mask"), &Slicer::slice_scene, Variant::NIL, 0xFFFFF);
+    ClassDB::bind_method(D_METHOD("dice", "mesh", "direction", "spacing", "cross_section_material"), &Slicer::dice, Variant::NIL);
+    ClassDB::bind_method(D_METHOD("dice_grid", "mesh", "cell_size", "cross_section_material"), &Slicer::dice_grid, Variant::NIL);
+    ClassDB::bind_method(D_METHOD("shatter", "mesh", "seed_points", "cross_section_material"), &Slicer::shatter, Variant::NIL);
+    ClassDB::bind_method(D_METHOD("clip_to_convex", "mesh", "planes", "cross_section_material", "keep_outside"), &Slicer::clip_to_convex, Variant::NIL, false);
+    ClassDB::bind_method(D_METHOD("get_worker_pool_stats"), &Slicer::get_worker_pool_stats);
+    ClassDB::bind_method(D_METHOD("reset_worker_pool_stats"), &Slicer::reset_worker_pool_stats);
+    ClassDB::bind_method(D_METHOD("start_trace", "path"), &Slicer::start_trace);
+    ClassDB::bind_method(D_METHOD("stop_trace"), &Slicer::stop_trace);
+
+    ClassDB::bind_method(D_METHOD("set_inherit_compression", "inherit_compression"), &Slicer::set_inherit_compression);
+    ClassDB::bind_method(D_METHOD("get_inherit_compression"), &Slicer::get_inherit_compression);
+    ClassDB::bind_method(D_METHOD("set_compression_flags", "compression_flags"), &Slicer::set_compression_flags);
+    ClassDB::bind_method(D_METHOD("get_compression_flags"), &Slicer::get_compression_flags);
+
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "inherit_compression"), "set_inherit_compression", "get_inherit_compression");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "compression_flags"), "set_compression_flags", "get_compression_flags");
+
+    ClassDB::bind_method(D_METHOD("set_vertex_buffer_mode", "vertex_buffer_mode"), &Slicer::set_vertex_buffer_mode);
+    ClassDB::bind_method(D_METHOD("get_vertex_buffer_mode"), &Slicer::get_vertex_buffer_mode);
+
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "vertex_buffer_mode", PROPERTY_HINT_ENUM, "Copy,Share,Consume"), "set_vertex_buffer_mode", "get_vertex_buffer_mode");
+
+    ClassDB::bind_method(D_METHOD("set_keep", "keep"), &Slicer::set_keep);
+    ClassDB::bind_method(D_METHOD("get_keep"), &Slicer::get_keep);
+
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "keep", PROPERTY_HINT_ENUM, "Both,Upper,Lower"), "set_keep", "get_keep");
+
+    ClassDB::bind_method(D_METHOD("set_merge_cross_section", "merge_cross_section"), &Slicer::set_merge_cross_section);
+    ClassDB::bind_method(D_METHOD("get_merge_cross_section"), &Slicer::get_merge_cross_section);
+    ClassDB::bind_method(D_METHOD("set_cross_section_uv_rect", "cross_section_uv_rect"), &Slicer::set_cross_section_uv_rect);
+    ClassDB::bind_method(D_METHOD("get_cross_section_uv_rect"), &Slicer::get_cross_section_uv_rect);
+
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "merge_cross_section"), "set_merge_cross_section", "get_merge_cross_section");
+    ADD_PROPERTY(PropertyInfo(Variant::RECT2, "cross_section_uv_rect"), "set_cross_section_uv_rect", "get_cross_section_uv_rect");
+
+    ClassDB::bind_method(D_METHOD("set_cache_decomposition", "cache_decomposition"), &Slicer::set_cache_decomposition);
+    ClassDB::bind_method(D_METHOD("get_cache_decomposition"), &Slicer::get_cache_decomposition);
+    ClassDB::bind_method(D_METHOD("set_use_bvh", "use_bvh"), &Slicer::set_use_bvh);
+    ClassDB::bind_method(D_METHOD("get_use_bvh"), &Slicer::get_use_bvh);
+    ClassDB::bind_method(D_METHOD("set_indexed_directions", "indexed_directions"), &Slicer::set_indexed_directions);
+    ClassDB::bind_method(D_METHOD("get_indexed_directions"), &Slicer::get_indexed_directions);
+    ClassDB::bind_method(D_METHOD("clear_cache"), &Slicer::clear_cache);
+
+    ClassDB::bind_method(D_METHOD("set_update_in_place", "update_in_place"), &Slicer::set_update_in_place);
+    ClassDB::bind_method(D_METHOD("get_update_in_place"), &Slicer::get_update_in_place);
+    ClassDB::bind_method(D_METHOD("set_pool_size", "pool_size"), &Slicer::set_pool_size);
+    ClassDB::bind_method(D_METHOD("get_pool_size"), &Slicer::get_pool_size);
+    ClassDB::bind_method(D_METHOD("release", "sliced_mesh"), &Slicer::release);
+    ClassDB::bind_method(D_METHOD("release_mesh", "mesh"), &Slicer::release_mesh);
+    ClassDB::bind_method(D_METHOD("clear_pool"), &Slicer::clear_pool);
+
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cache_decomposition"), "set_cache_decomposition", "get_cache_decomposition");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_bvh"), "set_use_bvh", "get_use_bvh");
+    ADD_PROPERTY(PropertyInfo(Variant::POOL_VECTOR3_ARRAY, "indexed_directions"), "set_indexed_directions", "get_indexed_directions");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "update_in_place"), "set_update_in_place", "get_update_in_place");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "pool_size"), "set_pool_size", "get_pool_size");
+
+    BIND_ENUM_CONSTANT(VERTEX_BUFFER_COPY);
+    BIND_ENUM_CONSTANT(VERTEX_BUFFER_SHARE);
+    BIND_ENUM_CONSTANT(VERTEX_BUFFER_CONSUME);
+
+    BIND_ENUM_CONSTANT(KEEP_BOTH);
+    BIND_ENUM_CONSTANT(KEEP_UPPER);
+    BIND_ENUM_CONSTANT(KEEP_LOWER);
 }
@@ -1,26 +1,308 @@
 #ifndef SLICER_H
 #define SLICER_H
 
+#include "core/map.h"
 #include "scene/3d/spatial.h"
 #include "scene/3d/mesh_instance.h"
 #include "sliced_mesh.h"
+#include "sliced_arrays.h"
+#include "slice_job.h"
+#include "slice_session.h"
+#include "utils/clipper.h"
+#include "utils/dicer.h"
+#include "utils/face_bvh.h"
+#include "utils/mesh_pool.h"
+#include "utils/shatterer.h"
+#include "utils/projection_index.h"
 
 /**
  * Helper for cutting a convex mesh along a plane and returning
- * two new meshes representing both sides of the cut
+ * two new meshes representing both sides of the cut.
+ *
+ * Slicer's methods are only meant to be called from the main thread. Its
+ * decomposition cache and mesh pool aren't locked, and cuts go through the
+ * scene and the VisualServer. Whatever can run in parallel is handed off to
+ * the WorkerPool from there
 */
 class Slicer : public Spatial {
     GDCLASS(Slicer, Spatial);
 
+public:
+    enum VertexBufferMode {
+        // Every vertex of the generated meshes is written out fresh
+        VERTEX_BUFFER_COPY,
+        // The generated surfaces reference the vertex buffers of the surfaces they were cut
+        // from, with only the vertexes created by the cut appended, and a new index buffer
+        VERTEX_BUFFER_SHARE,
+        // Like VERTEX_BUFFER_SHARE but the source mesh's surfaces are cleared so that
+        // its buffers can be taken over rather than copied. Only ArrayMeshes can be consumed
+        VERTEX_BUFFER_CONSUME,
+    };
+
+    enum Keep {
+        KEEP_BOTH,
+        // Only the part of the mesh above the plane is built, leaving lower_mesh null
+        KEEP_UPPER,
+        // Only the part of the mesh below the plane is built, leaving upper_mesh null
+        KEEP_LOWER,
+    };
+
+private:
+    /**
+     * A surface of a mesh that has already been broken down into faces, so that
+     * cutting the same mesh again doesn't have to redo that work
+    */
+    struct CachedSurface {
+        // Used to notice if the surface was swapped out from under us
+        uint32_t format;
+        int array_len;
+        int index_array_len;
+
+        Vector<SlicerFace> faces;
+        FaceBVH bvh;
+        ProjectionIndex projection_index;
+
+        CachedSurface() {
+            format = 0;
+            array_len = -1;
+            index_array_len = -1;
+        }
+    };
+
+    bool cache_decomposition;
+    bool use_bvh;
+    PoolVector<Vector3> indexed_directions;
+    Map<ObjectID, Vector<CachedSurface> > decomposition_cache;
+
+    /**
+     * Returns the decomposition of the given surface, parsing it (and building
+     * its BVH and projection index, if enabled) if we haven't seen it before
+    */
+    const CachedSurface &get_cached_surface(const Ref<Mesh> &mesh, int surface_idx);
+
+    /**
+     * Breaks every surface of the mesh down into faces (going through the cache if it's
+     * enabled) along with the material and compression their pieces should be given
+    */
+    Vector<SourceSurface> get_source_surfaces(const Ref<Mesh> &mesh);
+
+    /**
+     * Turns every cell that ended up with something in it into a mesh, leaving a null
+     * in place of each empty one so the meshes still line up with the cells
+    */
+    Array create_cell_meshes(const Vector<CellMesh> &cells, const Vector<SourceSurface> &sources, const Ref<Material> &cross_section_material);
+
+    /**
+     * Turns every diced cell that ended up with something in it into a Dictionary holding its
+     * mesh along with which slab ("index") or, for grids, which cell ("cell") it came from
+    */
+    Array create_diced_meshes(const Vector<CellMesh> &cells, const Dicer::Grid &grid, bool is_grid, const Vector<SourceSurface> &sources, const Ref<Material> &cross_section_material);
+
+    /**
+     * Builds the halves of a slice of the source mesh, recycling meshes from the pool
+     * when it's enabled and writing back into the source mesh if update_in_place is set (and
+     * can_reuse_source is). If the halves (upper first) have already been packed, they're
+     * written out as they are
+    */
+    Ref<SlicedMesh> create_sliced_mesh(const Ref<Mesh> &source, const Vector<Intersector::SplitResult> &split_results, const Vector<SlicerFace> &cross_section_faces, const Ref<Material> &cross_section_material, uint32_t cross_section_compression, const PackedHalf *packed_halves = NULL, const SurfaceFiller *packed_cross_section = NULL, bool can_reuse_source = true);
+
+    /**
+     * slice_by_plane for when the vertex buffers are being copied. The cut is broken up into a
+     * TaskGraph so that, on the WorkerPool, each surface is split on its own, its halves are
+     * packed as soon as it's done, and the cross section is triangulated alongside the packing.
+     * Only writing the halves into meshes is left to the calling thread
+    */
+    Ref<SlicedMesh> slice_in_stages(const Ref<Mesh> &mesh, const String &mesh_name, const Plane &plane, const Intersector::AxisPlane *axis_plane, const Ref<Material> &cross_section_material);
+
+    // Meshes that have been released and are waiting to be refilled. Disabled while its size is 0
+    MeshPool mesh_pool;
+
+    MeshPool *get_mesh_pool() {
+        return mesh_pool.max_size > 0 ? &mesh_pool : NULL;
+    }
+
+    uint32_t get_cross_section_compression(const Vector<SourceSurface> &sources) const {
+        // The cross section doesn't have a source surface of its own so, when
+        // inheriting, just follow whatever the first surface is doing
+        return inherit_compression && sources.size() > 0 ? sources[0].compression : compression_flags;
+    }
+
+    VertexBufferMode vertex_buffer_mode;
+
+    // Which halves of a slice get built. Faces that fall on a side that isn't
+    // being kept are thrown away as soon as they're found
+    Keep keep;
+
+    // Whether the generated surfaces should be packed with the same ARRAY_COMPRESS_*
+    // flags as the surfaces they were cut from or with compression_flags instead
+    bool inherit_compression;
+    int compression_flags;
+
+    // Whether the cross section should be merged into the surface sharing its material
+    // rather than being given a surface (and therefore a draw call) of its own
+    bool merge_cross_section;
+
+    // Whether the larger half of a slice should be written back into the ArrayMesh that was cut
+    // rather than into a new mesh. Only the other half ends up in a mesh of its own
+    bool update_in_place;
+
+    // The region of the cross section material's texture the cross section's UVs are mapped to
+    Rect2 cross_section_uv_rect;
+
 protected:
     static void _bind_methods();
 
 public:
+    void set_inherit_compression(bool p_inherit_compression) {
+        inherit_compression = p_inherit_compression;
+    }
+    bool get_inherit_compression() const {
+        return inherit_compression;
+    }
+
+    /**
+     * Only the ARRAY_COMPRESS_* bits are kept. Anything else would change the layout
+     * of the generated surfaces rather than just how they're packed
+    */
+    void set_compression_flags(int p_compression_flags);
+    int get_compression_flags() const {
+        return compression_flags;
+    }
+
+    void set_merge_cross_section(bool p_merge_cross_section) {
+        merge_cross_section = p_merge_cross_section;
+    }
+    bool get_merge_cross_section() const {
+        return merge_cross_section;
+    }
+
+    void set_cross_section_uv_rect(const Rect2 &p_cross_section_uv_rect) {
+        cross_section_uv_rect = p_cross_section_uv_rect;
+    }
+    Rect2 get_cross_section_uv_rect() const {
+        return cross_section_uv_rect;
+    }
+
+    void set_cache_decomposition(bool p_cache_decomposition) {
+        cache_decomposition = p_cache_decomposition;
+        if (!cache_decomposition) {
+            clear_cache();
+        }
+    }
+    bool get_cache_decomposition() const {
+        return cache_decomposition;
+    }
+
+    void set_use_bvh(bool p_use_bvh) {
+        use_bvh = p_use_bvh;
+        clear_cache();
+    }
+    bool get_use_bvh() const {
+        return use_bvh;
+    }
+
+    void set_indexed_directions(const PoolVector<Vector3> &p_indexed_directions) {
+        indexed_directions = p_indexed_directions;
+        clear_cache();
+    }
+    PoolVector<Vector3> get_indexed_directions() const {
+        return indexed_directions;
+    }
+
+    /**
+     * Forgets every mesh that has been decomposed. Surfaces are checked for changes
+     * in their size and format but anything more subtle (like vertexes being moved
+     * around with surface_update_region) requires the cache to be cleared by hand
+    */
+    void clear_cache() {
+        decomposition_cache.clear();
+    }
+
+    void set_vertex_buffer_mode(VertexBufferMode p_vertex_buffer_mode) {
+        vertex_buffer_mode = p_vertex_buffer_mode;
+    }
+    VertexBufferMode get_vertex_buffer_mode() const {
+        return vertex_buffer_mode;
+    }
+
+    void set_keep(Keep p_keep) {
+        keep = p_keep;
+    }
+    Keep get_keep() const {
+        return keep;
+    }
+
+    void set_update_in_place(bool p_update_in_place) {
+        update_in_place = p_update_in_place;
+    }
+    bool get_update_in_place() const {
+        return update_in_place;
+    }
+
+    void set_pool_size(int p_pool_size) {
+        mesh_pool.set_max_size(p_pool_size);
+    }
+    int get_pool_size() const {
+        return mesh_pool.max_size;
+    }
+
+    /**
+     * Hands the halves of a slice (and the SlicedMesh holding them) back to be reused by
+     * later cuts. Only has an effect while pool_size is above 0, and the meshes mustn't
+     * be used by anything else afterwards
+    */
+    void release(const Ref<SlicedMesh> &sliced_mesh) {
+        mesh_pool.release(sliced_mesh);
+    }
+
+    /**
+     * Same as release but for a single mesh, such as one of the pieces returned by dice or shatter
+    */
+    void release_mesh(const Ref<Mesh> &mesh) {
+        mesh_pool.release_mesh(mesh);
+    }
+
+    /**
+     * Drops every mesh that's waiting in the pool
+    */
+    void clear_pool() {
+        mesh_pool.clear();
+    }
+
     /**
      * Slice the passed in mesh along the passed in plane, setting the interrior cut surface to the passed in material
     */
     Ref<SlicedMesh> slice_by_plane(const Ref<Mesh> mesh, const Plane plane, const Ref<Material> cross_section_material);
 
+    /**
+     * Slices a set of Mesh::ARRAY_* arrays describing a single surface of triangles and returns
+     * the arrays for each half, without creating any meshes along the way. Returns null if the
+     * plane doesn't cut through them
+    */
+    Ref<SlicedArrays> slice_arrays(const Array &arrays, const Plane plane);
+
+    /**
+     * Works out what the cross section of a cut along the plane would look like, without building
+     * any meshes. Returns a Dictionary with the outlines of the cross section as "loops", the same
+     * outlines flattened onto the plane as "loops_2d", and its "area", "perimeter" and "bounds".
+     * The Dictionary is empty if the plane doesn't pass through the mesh
+    */
+    Dictionary query_cross_section(const Ref<Mesh> mesh, const Plane p_plane);
+
+    /**
+     * Sets the mesh up to be cut repeatedly by a plane that moves a little at a time (see SliceSession).
+     * The session holds on to this Slicer's compression, cross section UV rect and keep settings as
+     * they are now
+    */
+    Ref<SliceSession> create_session(const Ref<Mesh> mesh);
+
+    /**
+     * Sets up a cut along the plane that's made a bit at a time, through SliceJob::step, rather than
+     * all at once. The job holds on to this Slicer's compression, cross section and keep settings as
+     * they are now. Vertex buffers are always copied, as they would be with VERTEX_BUFFER_COPY
+    */
+    Ref<SliceJob> create_job(const Ref<Mesh> mesh, const Plane plane, const Ref<Material> cross_section_material);
+
     /**
      * Generates a plane based on the given position and normal and perform a cut along that plane
     */
@@ -30,7 +312,78 @@ public:
      * Generates a plane based on the given position and normal and offsets it by the given Transform before applying the slice
     */
     Ref<SlicedMesh> slice(const Ref<Mesh> mesh, const Transform mesh_transform, const Vector3 position, const Vector3 normal, const Ref<Material> cross_section_material);
-    Slicer() {};
+
+    /**
+     * Cuts every MeshInstance under root (including root itself) that's on one of the given
+     * layers and that the plane, given in global space, passes through. Candidates are found
+     * with the VisualServer's culling and the cuts are made in parallel. Returns a Dictionary
+     * with the "instance" and its "sliced_mesh" for every instance that was actually cut
+    */
+    Array slice_scene(Node *root, const Plane plane, const Ref<Material> cross_section_material, uint32_t layer_mask = 0xFFFFF);
+
+    /**
+     * Cuts the mesh into slabs every `spacing` units along the given direction (measured from the
+     * mesh's origin) in a single pass. Returns a Dictionary for every slab that isn't empty, ordered
+     * along the direction, with the slab's "mesh" and its "index" (slab n starting n * spacing
+     * from the origin)
+    */
+    Array dice(const Ref<Mesh> mesh, const Vector3 direction, real_t spacing, const Ref<Material> cross_section_material);
+
+    /**
+     * Cuts the mesh up into a grid of cells of the given size (with a cell corner at the mesh's
+     * origin) in a single pass. Returns a Dictionary for every cell that isn't empty, ordered along
+     * x first, then y, then z, with the cell's "mesh" and its grid coordinates as a Vector3 "cell"
+    */
+    Array dice_grid(const Ref<Mesh> mesh, const Vector3 cell_size, const Ref<Material> cross_section_material);
+
+    /**
+     * Cuts away everything outside of the convex volume bounded by the given planes (with their
+     * normals facing out of the volume) in a single pass. What's inside ends up in the returned
+     * SlicedMesh's lower_mesh, and what's outside in its upper_mesh if keep_outside is set
+    */
+    Ref<SlicedMesh> clip_to_convex(const Ref<Mesh> mesh, const Array &planes, const Ref<Material> cross_section_material, bool keep_outside = false);
+
+    /**
+     * Breaks the mesh apart into the Voronoi cells of the given seed points, returning a mesh for each
+     * seed, or null if its cell is empty. The cells are clipped in parallel, one processor's worth at a time
+    */
+    Array shatter(const Ref<Mesh> mesh, const PoolVector<Vector3> &seed_points, const Ref<Material> cross_section_material);
+
+    /**
+     * How much work the shared WorkerPool has gotten through. Returns a Dictionary with the pool's
+     * "thread_count", the number of parallel "batches" and individual "tasks" it's run, how many
+     * chunks of work were "steals" from another thread's queue, the "busy_usec" spent running tasks
+     * (summed over every thread) out of the "elapsed_usec" since the stats were last reset, and the
+     * "tasks_per_second" and "utilisation" that works out to. Empty if there's no pool running
+    */
+    Dictionary get_worker_pool_stats() const;
+
+    /**
+     * Zeroes the shared WorkerPool's stats
+    */
+    void reset_worker_pool_stats();
+
+    /**
+     * Starts recording how long every stage of every cut takes, on whatever thread it ran on,
+     * until stop_trace writes it all out to the file at path as Chrome trace events
+    */
+    Error start_trace(const String &path);
+    Error stop_trace();
+
+    Slicer() {
+        inherit_compression = true;
+        compression_flags = Mesh::ARRAY_COMPRESS_DEFAULT;
+        vertex_buffer_mode = VERTEX_BUFFER_COPY;
+        keep = KEEP_BOTH;
+        merge_cross_section = false;
+        update_in_place = false;
+        cache_decomposition = false;
+        use_bvh = false;
+        cross_section_uv_rect = Rect2(0, 0, 1, 1);
+    };
 };
 
+VARIANT_ENUM_CAST(Slicer::VertexBufferMode);
+VARIANT_ENUM_CAST(Slicer::Keep);
+
 #endif // SLICER_H
@@ -0,0 +1,81 @@
+#include "catch.hpp"
+#include "../slicer.h"
+#include "scene/resources/primitive_meshes.h"
+
+TEST_CASE( "[SliceJob]" ) {
+    Ref<SphereMesh> sphere_mesh;
+    sphere_mesh.instance();
+    Slicer slicer;
+    Plane plane(Vector3(1, 0, 0), 0.25);
+
+    SECTION( "Spreads the cut over several steps" ) {
+        Ref<SliceJob> job = slicer.create_job(sphere_mesh, plane, NULL);
+        REQUIRE_FALSE( job->is_done() );
+
+        // Without any budget every step only gets through a single chunk of work
+        int steps = 0;
+        while (!job->step(0)) {
+            REQUIRE( job->get_result().is_null() );
+            steps++;
+        }
+        REQUIRE( steps > 1 );
+        REQUIRE( job->is_done() );
+
+        Ref<SlicedMesh> expected = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+        Ref<SlicedMesh> sliced_mesh = job->get_result();
+        REQUIRE_FALSE( sliced_mesh.is_null() );
+        REQUIRE( sliced_mesh->upper_mesh->get_surface_count() == expected->upper_mesh->get_surface_count() );
+        REQUIRE( sliced_mesh->lower_mesh->get_surface_count() == expected->lower_mesh->get_surface_count() );
+        for (int i = 0; i < expected->upper_mesh->get_surface_count(); i++) {
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(i) == expected->upper_mesh->surface_get_array_len(i) );
+            REQUIRE( sliced_mesh->lower_mesh->surface_get_array_len(i) == expected->lower_mesh->surface_get_array_len(i) );
+        }
+
+        SECTION( "Stays done" ) {
+            REQUIRE( job->step(0) );
+            REQUIRE( job->get_result() == sliced_mesh );
+        }
+    }
+
+    SECTION( "Finishes in one step given enough time" ) {
+        Ref<SliceJob> job = slicer.create_job(sphere_mesh, plane, NULL);
+        REQUIRE( job->step(10000000) );
+        REQUIRE_FALSE( job->get_result().is_null() );
+    }
+
+    SECTION( "Ends up with nothing if the plane misses" ) {
+        Ref<SliceJob> job = slicer.create_job(sphere_mesh, Plane(Vector3(1, 0, 0), 10), NULL);
+        REQUIRE( job->step(10000000) );
+        REQUIRE( job->get_result().is_null() );
+    }
+
+    SECTION( "Starts from the decomposition cache" ) {
+        slicer.set_cache_decomposition(true);
+        Ref<SliceJob> job = slicer.create_job(sphere_mesh, plane, NULL);
+        while (!job->step(0)) {
+        }
+
+        Ref<SlicedMesh> expected = Slicer().slice_by_plane(sphere_mesh, plane, NULL);
+        REQUIRE( job->get_result()->upper_mesh->surface_get_array_len(0) == expected->upper_mesh->surface_get_array_len(0) );
+        REQUIRE( job->get_result()->lower_mesh->surface_get_array_len(0) == expected->lower_mesh->surface_get_array_len(0) );
+    }
+
+    SECTION( "Can merge the cross section" ) {
+        slicer.set_merge_cross_section(true);
+        Ref<SliceJob> job = slicer.create_job(sphere_mesh, plane, NULL);
+        while (!job->step(0)) {
+        }
+
+        Ref<SlicedMesh> expected = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+        REQUIRE( job->get_result()->upper_mesh->get_surface_count() == expected->upper_mesh->get_surface_count() );
+        REQUIRE( job->get_result()->upper_mesh->surface_get_array_len(0) == expected->upper_mesh->surface_get_array_len(0) );
+    }
+
+    SECTION( "Follows the slicer's keep setting" ) {
+        slicer.set_keep(Slicer::KEEP_LOWER);
+        Ref<SliceJob> job = slicer.create_job(sphere_mesh, plane, NULL);
+        REQUIRE( job->step(10000000) );
+        REQUIRE( job->get_result()->upper_mesh.is_null() );
+        REQUIRE_FALSE( job->get_result()->lower_mesh.is_null() );
+    }
+}
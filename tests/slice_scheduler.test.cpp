@@ -0,0 +1,126 @@
+#include "catch.hpp"
+#include "../slice_scheduler.h"
+#include "scene/3d/camera.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
+#include "scene/resources/primitive_meshes.h"
+
+TEST_CASE( "[SliceScheduler]" ) {
+    Ref<SphereMesh> sphere_mesh;
+    sphere_mesh.instance();
+
+    SliceScheduler *scheduler = memnew(SliceScheduler);
+    Slicer *slicer = memnew(Slicer);
+    slicer->set_name("Slicer");
+    scheduler->add_child(slicer);
+    scheduler->set_slicer_path(NodePath("Slicer"));
+
+    MeshInstance *first = memnew(MeshInstance);
+    first->set_mesh(sphere_mesh);
+    MeshInstance *second = memnew(MeshInstance);
+    second->set_mesh(sphere_mesh);
+
+    SECTION( "Folds cuts of the same instance together" ) {
+        scheduler->queue_slice(first, Plane(Vector3(1, 0, 0), 0), NULL);
+        scheduler->queue_slice(first, Plane(Vector3(1, 0, 0), 0.25), NULL);
+        REQUIRE( scheduler->get_pending_count() == 1 );
+
+        scheduler->queue_slice(second, Plane(Vector3(1, 0, 0), 0), NULL);
+        REQUIRE( scheduler->get_pending_count() == 2 );
+
+        scheduler->cancel(first);
+        REQUIRE( scheduler->get_pending_count() == 1 );
+    }
+
+    SECTION( "Makes every cut when flushed" ) {
+        scheduler->queue_slice(first, Plane(Vector3(1, 0, 0), 0), NULL);
+        scheduler->queue_slice(second, Plane(Vector3(0, 1, 0), 0), NULL);
+        scheduler->flush();
+        REQUIRE( scheduler->get_pending_count() == 0 );
+    }
+
+    SECTION( "Leaves cuts over the face budget for later" ) {
+        scheduler->set_budget_faces(1);
+        scheduler->queue_slice(first, Plane(Vector3(1, 0, 0), 0), NULL);
+        scheduler->queue_slice(second, Plane(Vector3(0, 1, 0), 0), NULL);
+
+        // The first cut is always made, however small the budget
+        scheduler->notification(Node::NOTIFICATION_PROCESS);
+        REQUIRE( scheduler->get_pending_count() == 1 );
+
+        scheduler->notification(Node::NOTIFICATION_PROCESS);
+        REQUIRE( scheduler->get_pending_count() == 0 );
+    }
+
+    SECTION( "Always makes critical cuts" ) {
+        scheduler->set_budget_faces(1);
+        scheduler->queue_slice(first, Plane(Vector3(1, 0, 0), 0), NULL, true);
+        scheduler->queue_slice(second, Plane(Vector3(0, 1, 0), 0), NULL, true);
+        scheduler->notification(Node::NOTIFICATION_PROCESS);
+        REQUIRE( scheduler->get_pending_count() == 0 );
+    }
+
+    SECTION( "Ignores planes without a normal" ) {
+        scheduler->queue_slice(first, Plane(), NULL);
+        REQUIRE( scheduler->get_pending_count() == 0 );
+    }
+
+    SECTION( "Cuts critical instances first, then ones on screen, then the nearest" ) {
+        SceneTree *tree = memnew(SceneTree);
+        tree->init();
+        tree->get_root()->set_size(Size2(640, 480));
+        tree->get_root()->add_child(scheduler);
+
+        // Looking down -z from the origin
+        Camera *camera = memnew(Camera);
+        tree->get_root()->add_child(camera);
+        camera->make_current();
+
+        MeshInstance *behind = memnew(MeshInstance);
+        behind->set_mesh(sphere_mesh);
+        behind->set_translation(Vector3(0, 0, 5));
+        MeshInstance *critical = memnew(MeshInstance);
+        critical->set_mesh(sphere_mesh);
+        critical->set_translation(Vector3(0, 0, 50));
+
+        first->set_translation(Vector3(0, 0, -50));
+        second->set_translation(Vector3(0, 0, -10));
+
+        MeshInstance *instances[4] = { behind, first, second, critical };
+        for (int i = 0; i < 4; i++) {
+            tree->get_root()->add_child(instances[i]);
+        }
+
+        // Queued least important first, and the face budget only lets one cut through each frame.
+        // Cancelling an instance that's already been cut leaves the queue as it is
+        scheduler->set_budget_faces(1);
+        scheduler->queue_slice(behind, Plane(Vector3(1, 0, 0), 0), NULL);
+        scheduler->queue_slice(first, Plane(Vector3(1, 0, 0), 0), NULL);
+        scheduler->queue_slice(second, Plane(Vector3(1, 0, 0), 0), NULL);
+        scheduler->queue_slice(critical, Plane(Vector3(1, 0, 0), 0), NULL, true);
+
+        MeshInstance *expected_order[3] = { critical, second, first };
+        for (int i = 0; i < 3; i++) {
+            scheduler->notification(Node::NOTIFICATION_PROCESS);
+            REQUIRE( scheduler->get_pending_count() == 3 - i );
+            scheduler->cancel(expected_order[i]);
+            REQUIRE( scheduler->get_pending_count() == 3 - i );
+        }
+
+        scheduler->cancel(behind);
+        REQUIRE( scheduler->get_pending_count() == 0 );
+
+        for (int i = 0; i < 4; i++) {
+            tree->get_root()->remove_child(instances[i]);
+        }
+        memdelete(behind);
+        memdelete(critical);
+        tree->get_root()->remove_child(scheduler);
+        tree->finish();
+        memdelete(tree);
+    }
+
+    memdelete(first);
+    memdelete(second);
+    memdelete(scheduler);
+}
@@ -0,0 +1,73 @@
+#include "catch.hpp"
+#include "../slicer.h"
+#include "scene/resources/primitive_meshes.h"
+
+TEST_CASE( "[SliceSession]" ) {
+    Ref<SphereMesh> sphere_mesh;
+    sphere_mesh.instance();
+    Slicer slicer;
+    Ref<SliceSession> session = slicer.create_session(sphere_mesh);
+    REQUIRE_FALSE( session.is_null() );
+
+    SECTION( "Matches a regular slice" ) {
+        Plane planes[3] = { Plane(Vector3(0, 1, 0), 0.2), Plane(Vector3(0, 1, 0), 0.25), Plane(Vector3(0.05, 1, 0).normalized(), 0.3) };
+
+        for (int i = 0; i < 3; i++) {
+            Ref<SlicedMesh> expected = slicer.slice_by_plane(sphere_mesh, planes[i], NULL);
+            Ref<SlicedMesh> sliced_mesh = session->slice(planes[i], NULL);
+            REQUIRE_FALSE( sliced_mesh.is_null() );
+
+            REQUIRE( sliced_mesh->upper_mesh->get_surface_count() == expected->upper_mesh->get_surface_count() );
+            REQUIRE( sliced_mesh->lower_mesh->get_surface_count() == expected->lower_mesh->get_surface_count() );
+            for (int j = 0; j < expected->upper_mesh->get_surface_count(); j++) {
+                REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(j) == expected->upper_mesh->surface_get_array_len(j) );
+                REQUIRE( sliced_mesh->lower_mesh->surface_get_array_len(j) == expected->lower_mesh->surface_get_array_len(j) );
+            }
+
+            REQUIRE( sliced_mesh->upper_mesh->get_aabb().position.y >= Approx(planes[i].d - 0.1) );
+        }
+    }
+
+    SECTION( "Only looks at the faces near the plane" ) {
+        session->slice(Plane(Vector3(0, 1, 0), 0.2), NULL);
+        REQUIRE( session->get_last_cut_face_count() > 0 );
+        REQUIRE( session->get_last_cut_face_count() < sphere_mesh->surface_get_array_len(0) / 6 );
+    }
+
+    SECTION( "Reuses its results" ) {
+        Ref<SlicedMesh> first = session->slice(Plane(Vector3(0, 1, 0), 0.2), NULL);
+        Ref<Mesh> upper_mesh = first->upper_mesh;
+        Ref<SlicedMesh> second = session->slice(Plane(Vector3(0, 1, 0), 0.21), NULL);
+
+        REQUIRE( second == first );
+        REQUIRE( second->upper_mesh == upper_mesh );
+    }
+
+    SECTION( "Normalizes the plane" ) {
+        Ref<SlicedMesh> expected = slicer.slice_by_plane(sphere_mesh, Plane(Vector3(0, 1, 0), 0.2), NULL);
+        Ref<SlicedMesh> sliced_mesh = session->slice(Plane(Vector3(0, 4, 0), 0.8), NULL);
+        REQUIRE_FALSE( sliced_mesh.is_null() );
+
+        REQUIRE( sliced_mesh->upper_mesh->get_surface_count() == expected->upper_mesh->get_surface_count() );
+        for (int j = 0; j < expected->upper_mesh->get_surface_count(); j++) {
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(j) == expected->upper_mesh->surface_get_array_len(j) );
+            REQUIRE( sliced_mesh->lower_mesh->surface_get_array_len(j) == expected->lower_mesh->surface_get_array_len(j) );
+        }
+        REQUIRE( sliced_mesh->upper_mesh->get_aabb().position.y == Approx(expected->upper_mesh->get_aabb().position.y) );
+    }
+
+    SECTION( "Rejects a plane without a normal" ) {
+        REQUIRE( session->slice(Plane(), NULL).is_null() );
+    }
+
+    SECTION( "Returns null when the plane misses" ) {
+        REQUIRE( session->slice(Plane(Vector3(0, 1, 0), 5), NULL).is_null() );
+    }
+
+    SECTION( "Follows the slicer's keep setting" ) {
+        slicer.set_keep(Slicer::KEEP_UPPER);
+        Ref<SlicedMesh> sliced_mesh = slicer.create_session(sphere_mesh)->slice(Plane(Vector3(0, 1, 0), 0.2), NULL);
+        REQUIRE_FALSE( sliced_mesh->upper_mesh.is_null() );
+        REQUIRE( sliced_mesh->lower_mesh.is_null() );
+    }
+}
@@ -4,7 +4,7 @@
 TEST_CASE( "[SlicedMesh]") {
     SECTION("Creates new meshes") {
         Intersector::SplitResult result;
-        PoolVector<Intersector::SplitResult> results;
+        Vector<Intersector::SplitResult> results;
         result.material = Ref<SpatialMaterial>();
         result.lower_faces.push_back(SlicerFace(Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(0, 1, 1)));
         result.lower_faces.push_back(SlicerFace(Vector3(0, 1, 1), Vector3(0, 0, 1), Vector3(0, 0, 0)));
@@ -14,7 +14,7 @@ TEST_CASE( "[SlicedMesh]") {
 
         results.push_back(result);
 
-        PoolVector<SlicerFace> cross_section_faces;
+        Vector<SlicerFace> cross_section_faces;
         Ref<SpatialMaterial> cross_section_material;
         cross_section_faces.push_back(SlicerFace(Vector3(0, 1, 0), Vector3(1, 1, 0), Vector3(0, 1, 1)));
 
@@ -30,5 +30,93 @@ TEST_CASE( "[SlicedMesh]") {
 
         REQUIRE(sliced.upper_mesh->surface_get_material(0) == result.material);
         REQUIRE(sliced.upper_mesh->surface_get_material(1) == cross_section_material);
+
+        SECTION("Shares cross section vertexes between both halves") {
+            Array upper_arrays = sliced.upper_mesh->surface_get_arrays(1);
+            Array lower_arrays = sliced.lower_mesh->surface_get_arrays(1);
+
+            PoolVector<Vector3> upper_vertices = upper_arrays[Mesh::ARRAY_VERTEX];
+            PoolVector<Vector3> lower_vertices = lower_arrays[Mesh::ARRAY_VERTEX];
+            REQUIRE(upper_vertices.size() == 3);
+            REQUIRE(lower_vertices.size() == 3);
+            for (int i = 0; i < 3; i++) {
+                REQUIRE(upper_vertices[i] == lower_vertices[i]);
+            }
+
+            // Only the winding differs
+            PoolVector<int> upper_indices = upper_arrays[Mesh::ARRAY_INDEX];
+            PoolVector<int> lower_indices = lower_arrays[Mesh::ARRAY_INDEX];
+            REQUIRE(upper_indices.size() == 3);
+            REQUIRE(lower_indices.size() == 3);
+            REQUIRE((upper_indices[0] == 0 && upper_indices[1] == 2 && upper_indices[2] == 1));
+            REQUIRE((lower_indices[0] == 0 && lower_indices[1] == 1 && lower_indices[2] == 2));
+        }
+    }
+
+    SECTION("Merges the cross section into a matching surface") {
+        Ref<SpatialMaterial> material;
+        material.instance();
+
+        Intersector::SplitResult result;
+        Vector<Intersector::SplitResult> results;
+        result.material = material;
+        result.lower_faces.push_back(SlicerFace(Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(0, 1, 1)));
+        result.upper_faces.push_back(SlicerFace(Vector3(0, 1, 0), Vector3(0, 2, 0), Vector3(0, 2, 1)));
+        results.push_back(result);
+
+        Vector<SlicerFace> cross_section_faces;
+        cross_section_faces.push_back(SlicerFace(Vector3(0, 1, 0), Vector3(1, 1, 0), Vector3(0, 1, 1)));
+
+        SECTION("When the materials match") {
+            SlicedMesh sliced(results, cross_section_faces, material, Mesh::ARRAY_COMPRESS_DEFAULT, true);
+            REQUIRE(sliced.upper_mesh->get_surface_count() == 1);
+            REQUIRE(sliced.lower_mesh->get_surface_count() == 1);
+            REQUIRE(sliced.upper_mesh->surface_get_material(0) == material);
+
+            PoolVector<Vector3> upper_vertices = sliced.upper_mesh->surface_get_arrays(0)[Mesh::ARRAY_VERTEX];
+            PoolVector<Vector3> lower_vertices = sliced.lower_mesh->surface_get_arrays(0)[Mesh::ARRAY_VERTEX];
+            REQUIRE(upper_vertices.size() == 6);
+            REQUIRE(lower_vertices.size() == 6);
+
+            // The upper half gets the reversed winding
+            REQUIRE(upper_vertices[4] == Vector3(0, 1, 1));
+            REQUIRE(lower_vertices[4] == Vector3(1, 1, 0));
+        }
+
+        SECTION("When no cross section material is given") {
+            SlicedMesh sliced(results, cross_section_faces, Ref<Material>(), Mesh::ARRAY_COMPRESS_DEFAULT, true);
+            REQUIRE(sliced.upper_mesh->get_surface_count() == 1);
+            REQUIRE(sliced.lower_mesh->get_surface_count() == 1);
+        }
+
+        SECTION("Past a skinned surface with the same material") {
+            Intersector::SplitResult skinned;
+            skinned.material = material;
+            SlicerFace skinned_face(Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(0, 1, 1));
+            skinned_face.set_bones(SlicerVector4(0, 0, 0, 0), SlicerVector4(0, 0, 0, 0), SlicerVector4(0, 0, 0, 0));
+            skinned_face.set_weights(SlicerVector4(1, 0, 0, 0), SlicerVector4(1, 0, 0, 0), SlicerVector4(1, 0, 0, 0));
+            skinned.lower_faces.push_back(skinned_face);
+            skinned.upper_faces.push_back(skinned_face);
+            results.insert(0, skinned);
+
+            SlicedMesh sliced(results, cross_section_faces, material, Mesh::ARRAY_COMPRESS_DEFAULT, true);
+            REQUIRE(sliced.upper_mesh->get_surface_count() == 2);
+            REQUIRE(sliced.upper_mesh->surface_get_array_len(0) == 3);
+            REQUIRE(sliced.upper_mesh->surface_get_array_len(1) == 6);
+
+            // With no material, the one the first surface uses is looked for
+            SlicedMesh unmaterialled(results, cross_section_faces, Ref<Material>(), Mesh::ARRAY_COMPRESS_DEFAULT, true);
+            REQUIRE(unmaterialled.upper_mesh->get_surface_count() == 2);
+            REQUIRE(unmaterialled.upper_mesh->surface_get_array_len(1) == 6);
+        }
+
+        SECTION("Not when the materials differ") {
+            Ref<SpatialMaterial> other_material;
+            other_material.instance();
+
+            SlicedMesh sliced(results, cross_section_faces, other_material, Mesh::ARRAY_COMPRESS_DEFAULT, true);
+            REQUIRE(sliced.upper_mesh->get_surface_count() == 2);
+            REQUIRE(sliced.upper_mesh->surface_get_material(1) == other_material);
+        }
     }
 }
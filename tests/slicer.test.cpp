@@ -1,7 +1,18 @@
 #include "catch.hpp"
 #include "../slicer.h"
+#include "../utils/worker_pool.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
 #include "scene/resources/primitive_meshes.h"
 
+MeshInstance *add_mesh_instance(Node *parent, const Ref<Mesh> &mesh, const Vector3 &translation) {
+    MeshInstance *instance = memnew(MeshInstance);
+    instance->set_mesh(mesh);
+    instance->set_translation(translation);
+    parent->add_child(instance);
+    return instance;
+}
+
 TEST_CASE( "[Slicer]" ) {
     Plane plane(Vector3(1, 0, 0), 0);
 
@@ -14,4 +25,620 @@ TEST_CASE( "[Slicer]" ) {
         REQUIRE_FALSE( sliced_mesh->upper_mesh.is_null() );
         REQUIRE_FALSE( sliced_mesh->lower_mesh.is_null() );
     }
+
+    SECTION( "Compression" ) {
+        Ref<SphereMesh> sphere_mesh;
+        sphere_mesh.instance();
+        Slicer slicer;
+
+        SECTION( "Inherits the source surface's compression by default" ) {
+            // Unlike compression_flags' default, the source isn't compressed at all
+            Ref<ArrayMesh> uncompressed;
+            uncompressed.instance();
+            uncompressed->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, sphere_mesh->surface_get_arrays(0), Array(), 0);
+            REQUIRE( (uncompressed->surface_get_format(0) & Mesh::ARRAY_COMPRESS_DEFAULT) == 0 );
+
+            Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(uncompressed, plane, NULL);
+            REQUIRE( (sliced_mesh->upper_mesh->surface_get_format(0) & Mesh::ARRAY_COMPRESS_DEFAULT) == 0 );
+            REQUIRE( (sliced_mesh->lower_mesh->surface_get_format(0) & Mesh::ARRAY_COMPRESS_DEFAULT) == 0 );
+            REQUIRE( (sliced_mesh->upper_mesh->surface_get_format(1) & Mesh::ARRAY_COMPRESS_DEFAULT) == 0 );
+
+            slicer.set_inherit_compression(false);
+            Ref<SlicedMesh> compressed = slicer.slice_by_plane(uncompressed, plane, NULL);
+            REQUIRE( (compressed->upper_mesh->surface_get_format(0) & Mesh::ARRAY_COMPRESS_DEFAULT) == Mesh::ARRAY_COMPRESS_DEFAULT );
+        }
+
+        SECTION( "Only keeps the compression bits of its flags" ) {
+            slicer.set_compression_flags(Mesh::ARRAY_COMPRESS_DEFAULT | Mesh::ARRAY_FLAG_USE_2D_VERTICES | Mesh::ARRAY_FORMAT_BONES);
+            REQUIRE( slicer.get_compression_flags() == Mesh::ARRAY_COMPRESS_DEFAULT );
+        }
+
+        SECTION( "Can use explicit compression flags" ) {
+            slicer.set_inherit_compression(false);
+            slicer.set_compression_flags(0);
+            Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+            REQUIRE( (sliced_mesh->upper_mesh->surface_get_format(0) & Mesh::ARRAY_COMPRESS_DEFAULT) == 0 );
+            REQUIRE( (sliced_mesh->lower_mesh->surface_get_format(1) & Mesh::ARRAY_COMPRESS_DEFAULT) == 0 );
+        }
+    }
+
+    SECTION( "Decomposition cache" ) {
+        Ref<SphereMesh> sphere_mesh;
+        sphere_mesh.instance();
+        Slicer slicer;
+        slicer.set_cache_decomposition(true);
+
+        Ref<SlicedMesh> uncached = Slicer().slice_by_plane(sphere_mesh, plane, NULL);
+
+        SECTION( "Gives the same result when reused" ) {
+            slicer.slice_by_plane(sphere_mesh, plane, NULL);
+            Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(0) == uncached->upper_mesh->surface_get_array_len(0) );
+            REQUIRE( sliced_mesh->lower_mesh->surface_get_array_len(0) == uncached->lower_mesh->surface_get_array_len(0) );
+        }
+
+        SECTION( "Can use a BVH" ) {
+            slicer.set_use_bvh(true);
+            Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(0) == uncached->upper_mesh->surface_get_array_len(0) );
+            REQUIRE( sliced_mesh->lower_mesh->surface_get_array_len(0) == uncached->lower_mesh->surface_get_array_len(0) );
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(1) == uncached->upper_mesh->surface_get_array_len(1) );
+        }
+
+        SECTION( "Can use a projection index" ) {
+            PoolVector<Vector3> directions;
+            directions.push_back(Vector3(1, 0, 0));
+            slicer.set_indexed_directions(directions);
+
+            Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(0) == uncached->upper_mesh->surface_get_array_len(0) );
+            REQUIRE( sliced_mesh->lower_mesh->surface_get_array_len(0) == uncached->lower_mesh->surface_get_array_len(0) );
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(1) == uncached->upper_mesh->surface_get_array_len(1) );
+        }
+    }
+
+    SECTION( "Vertex buffer modes" ) {
+        Ref<SphereMesh> sphere_mesh;
+        sphere_mesh.instance();
+        Slicer slicer;
+
+        SECTION( "Shares the source vertex buffer" ) {
+            slicer.set_vertex_buffer_mode(Slicer::VERTEX_BUFFER_SHARE);
+            Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+            REQUIRE_FALSE( sliced_mesh.is_null() );
+
+            int vertex_count = sliced_mesh->upper_mesh->surface_get_array_len(0);
+            REQUIRE( vertex_count > sphere_mesh->surface_get_array_len(0) );
+            REQUIRE( sliced_mesh->lower_mesh->surface_get_array_len(0) == vertex_count );
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_format(0) & Mesh::ARRAY_FORMAT_INDEX );
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_format(0) == (sphere_mesh->surface_get_format(0) | Mesh::ARRAY_FORMAT_INDEX) );
+
+            // The cross section is still a surface of its own
+            REQUIRE( sliced_mesh->upper_mesh->get_surface_count() == 2 );
+        }
+
+        SECTION( "Consumes the source mesh" ) {
+            Ref<ArrayMesh> array_mesh;
+            array_mesh.instance();
+            array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, sphere_mesh->surface_get_arrays(0));
+            slicer.set_vertex_buffer_mode(Slicer::VERTEX_BUFFER_CONSUME);
+
+            // Nothing gets consumed if there was no cut
+            Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(array_mesh, Plane(Vector3(1, 0, 0), 10), NULL);
+            REQUIRE( sliced_mesh.is_null() );
+            REQUIRE( array_mesh->get_surface_count() == 1 );
+
+            sliced_mesh = slicer.slice_by_plane(array_mesh, plane, NULL);
+            REQUIRE_FALSE( sliced_mesh.is_null() );
+            REQUIRE( array_mesh->get_surface_count() == 0 );
+            REQUIRE( sliced_mesh->upper_mesh->get_surface_count() == 2 );
+            REQUIRE( sliced_mesh->lower_mesh->get_surface_count() == 2 );
+        }
+    }
+
+    SECTION( "Keeping one side" ) {
+        Ref<SphereMesh> sphere_mesh;
+        sphere_mesh.instance();
+        Slicer slicer;
+        Ref<SlicedMesh> both = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+
+        SECTION( "Only builds the upper half" ) {
+            slicer.set_keep(Slicer::KEEP_UPPER);
+            Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+            REQUIRE( sliced_mesh->lower_mesh.is_null() );
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(0) == both->upper_mesh->surface_get_array_len(0) );
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(1) == both->upper_mesh->surface_get_array_len(1) );
+        }
+
+        SECTION( "Only builds the lower half" ) {
+            slicer.set_keep(Slicer::KEEP_LOWER);
+            slicer.set_cache_decomposition(true);
+            slicer.set_use_bvh(true);
+            Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+            REQUIRE( sliced_mesh->upper_mesh.is_null() );
+            REQUIRE( sliced_mesh->lower_mesh->surface_get_array_len(0) == both->lower_mesh->surface_get_array_len(0) );
+        }
+    }
+
+    SECTION( "Slicing raw arrays" ) {
+        Ref<SphereMesh> sphere_mesh;
+        sphere_mesh.instance();
+        Slicer slicer;
+        Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+
+        SECTION( "Gives the same halves as slicing a mesh" ) {
+            Ref<SlicedArrays> sliced_arrays = slicer.slice_arrays(sphere_mesh->surface_get_arrays(0), plane);
+            REQUIRE_FALSE( sliced_arrays.is_null() );
+
+            PoolVector<Vector3> upper_vertices = sliced_arrays->upper_arrays[Mesh::ARRAY_VERTEX];
+            PoolVector<Vector3> lower_vertices = sliced_arrays->lower_arrays[Mesh::ARRAY_VERTEX];
+            PoolVector<Vector3> cross_section_vertices = sliced_arrays->upper_cross_section_arrays[Mesh::ARRAY_VERTEX];
+            REQUIRE( upper_vertices.size() == sliced_mesh->upper_mesh->surface_get_array_len(0) );
+            REQUIRE( lower_vertices.size() == sliced_mesh->lower_mesh->surface_get_array_len(0) );
+            REQUIRE( cross_section_vertices.size() == sliced_mesh->upper_mesh->surface_get_array_len(1) );
+
+            // The arrays can go straight into a mesh
+            Ref<ArrayMesh> array_mesh;
+            array_mesh.instance();
+            array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, sliced_arrays->lower_arrays);
+            REQUIRE( array_mesh->surface_get_array_len(0) == lower_vertices.size() );
+        }
+
+        SECTION( "Returns null if there's no cut" ) {
+            REQUIRE( slicer.slice_arrays(sphere_mesh->surface_get_arrays(0), Plane(Vector3(1, 0, 0), 10)).is_null() );
+        }
+
+        SECTION( "Rejects arrays it can't read" ) {
+            Array arrays = sphere_mesh->surface_get_arrays(0);
+
+            Array bad_index = arrays.duplicate();
+            PoolVector<int> indices = arrays[Mesh::ARRAY_INDEX];
+            indices.set(0, 1000000);
+            bad_index[Mesh::ARRAY_INDEX] = indices;
+            REQUIRE( slicer.slice_arrays(bad_index, plane).is_null() );
+
+            Array bad_vertexes = arrays.duplicate();
+            bad_vertexes[Mesh::ARRAY_VERTEX] = PoolVector<Vector2>();
+            REQUIRE( slicer.slice_arrays(bad_vertexes, plane).is_null() );
+        }
+
+        SECTION( "Only fills in the halves being kept" ) {
+            slicer.set_keep(Slicer::KEEP_LOWER);
+            Ref<SlicedArrays> sliced_arrays = slicer.slice_arrays(sphere_mesh->surface_get_arrays(0), plane);
+            REQUIRE( sliced_arrays->upper_arrays.empty() );
+            REQUIRE( sliced_arrays->upper_cross_section_arrays.empty() );
+            REQUIRE_FALSE( sliced_arrays->lower_arrays.empty() );
+        }
+    }
+
+    SECTION( "Querying the cross section" ) {
+        Ref<SphereMesh> sphere_mesh;
+        sphere_mesh.instance();
+        Slicer slicer;
+
+        SECTION( "Describes the cut without making it" ) {
+            Dictionary result = slicer.query_cross_section(sphere_mesh, Plane(Vector3(0, 1, 0), 0.6));
+            REQUIRE_FALSE( result.empty() );
+
+            Array loops = result["loops"];
+            Array loops_2d = result["loops_2d"];
+            REQUIRE( loops.size() == 1 );
+            REQUIRE( loops_2d.size() == 1 );
+
+            PoolVector<Vector3> points = loops[0];
+            PoolVector<Vector2> points_2d = loops_2d[0];
+            REQUIRE( points.size() >= sphere_mesh->get_radial_segments() );
+            REQUIRE( points_2d.size() == points.size() );
+            for (int i = 0; i < points.size(); i++) {
+                REQUIRE( points[i].y == Approx(0.6) );
+            }
+
+            // A circle with a radius of 0.8, give or take the sphere's segments
+            REQUIRE( (real_t)result["area"] == Approx(Math_PI * 0.64).epsilon(0.01) );
+            REQUIRE( (real_t)result["perimeter"] == Approx(Math_PI * 1.6).epsilon(0.01) );
+
+            AABB bounds = result["bounds"];
+            REQUIRE( bounds.size.y == Approx(0) );
+            REQUIRE( bounds.size.x == Approx(1.6).epsilon(0.01) );
+        }
+
+        SECTION( "Normalizes the plane" ) {
+            Dictionary expected = slicer.query_cross_section(sphere_mesh, Plane(Vector3(0, 1, 0), 0.6));
+            Dictionary result = slicer.query_cross_section(sphere_mesh, Plane(Vector3(0, 3, 0), 1.8));
+            REQUIRE( (real_t)result["area"] == Approx((real_t)expected["area"]) );
+
+            Array loops_2d = result["loops_2d"];
+            Array expected_loops_2d = expected["loops_2d"];
+            PoolVector<Vector2> points_2d = loops_2d[0];
+            PoolVector<Vector2> expected_points_2d = expected_loops_2d[0];
+            REQUIRE( points_2d.size() == expected_points_2d.size() );
+            for (int i = 0; i < points_2d.size(); i++) {
+                REQUIRE( points_2d[i].x == Approx(expected_points_2d[i].x) );
+                REQUIRE( points_2d[i].y == Approx(expected_points_2d[i].y) );
+            }
+        }
+
+        SECTION( "Returns nothing if there's no cut" ) {
+            REQUIRE( slicer.query_cross_section(sphere_mesh, Plane(Vector3(0, 1, 0), 10)).empty() );
+        }
+    }
+
+    SECTION( "Mesh pool" ) {
+        Ref<SphereMesh> sphere_mesh;
+        sphere_mesh.instance();
+        Slicer slicer;
+        slicer.set_pool_size(2);
+
+        Ref<SlicedMesh> first = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+        Ref<Mesh> upper_mesh = first->upper_mesh;
+        RID upper_rid = upper_mesh->get_rid();
+        int upper_len = upper_mesh->surface_get_array_len(0);
+
+        SECTION( "Reuses released meshes" ) {
+            slicer.release(first);
+            REQUIRE( first->upper_mesh.is_null() );
+            REQUIRE( upper_mesh->get_surface_count() == 0 );
+
+            Ref<SlicedMesh> second = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+            REQUIRE( second == first );
+            REQUIRE( (second->upper_mesh == upper_mesh || second->lower_mesh == upper_mesh) );
+            REQUIRE( upper_mesh->get_rid() == upper_rid );
+            REQUIRE( second->upper_mesh->surface_get_array_len(0) == upper_len );
+            REQUIRE( second->upper_mesh->get_surface_count() == 2 );
+        }
+
+        SECTION( "Clears out blend shapes and custom bounds" ) {
+            Ref<ArrayMesh> shaped_mesh;
+            shaped_mesh.instance();
+            shaped_mesh->add_blend_shape("open");
+            shaped_mesh->set_custom_aabb(AABB(Vector3(5, 5, 5), Vector3(1, 1, 1)));
+
+            slicer.release_mesh(shaped_mesh);
+            REQUIRE( shaped_mesh->get_blend_shape_count() == 0 );
+            REQUIRE( shaped_mesh->get_custom_aabb() == AABB() );
+
+            Ref<SlicedMesh> second = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+            REQUIRE( (second->upper_mesh == shaped_mesh || second->lower_mesh == shaped_mesh) );
+            REQUIRE( shaped_mesh->get_surface_count() == 2 );
+            REQUIRE( shaped_mesh->get_aabb().size.x == Approx(1) );
+        }
+
+        SECTION( "Doesn't pool anything when disabled" ) {
+            slicer.set_pool_size(0);
+            slicer.release(first);
+            REQUIRE_FALSE( first->upper_mesh.is_null() );
+            REQUIRE( upper_mesh->get_surface_count() == 2 );
+        }
+    }
+
+    SECTION( "Updating in place" ) {
+        Ref<SphereMesh> sphere_mesh;
+        sphere_mesh.instance();
+        Ref<ArrayMesh> array_mesh;
+        array_mesh.instance();
+        array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, sphere_mesh->surface_get_arrays(0));
+        RID rid = array_mesh->get_rid();
+
+        Slicer slicer;
+        slicer.set_update_in_place(true);
+        slicer.set_cache_decomposition(true);
+
+        Plane off_center(Vector3(1, 0, 0), 0.5);
+        Ref<SlicedMesh> expected = Slicer().slice_by_plane(array_mesh, off_center, NULL);
+        Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(array_mesh, off_center, NULL);
+
+        SECTION( "Writes the larger half back into the mesh" ) {
+            REQUIRE( sliced_mesh->lower_mesh == array_mesh );
+            REQUIRE( array_mesh->get_rid() == rid );
+            REQUIRE( sliced_mesh->upper_mesh != array_mesh );
+            REQUIRE( array_mesh->get_surface_count() == 2 );
+            REQUIRE( array_mesh->surface_get_array_len(0) == expected->lower_mesh->surface_get_array_len(0) );
+            REQUIRE( array_mesh->surface_get_array_len(1) == expected->lower_mesh->surface_get_array_len(1) );
+        }
+
+        SECTION( "Notices the mesh changed when cutting it again" ) {
+            Ref<SlicedMesh> second = slicer.slice_by_plane(array_mesh, Plane(Vector3(0, 1, 0), 0.5), NULL);
+            REQUIRE( second->lower_mesh == array_mesh );
+
+            // Cutting what was cached from before the first cut would bring back the part of
+            // the sphere that went into the first upper half
+            REQUIRE( second->upper_mesh->get_aabb().get_end().x <= Approx(0.5) );
+        }
+
+        SECTION( "Overwrites the vertexes of surfaces the new half fits into" ) {
+            // The sphere was indexed, so the first cut had to re-add its surfaces, but halves
+            // never are, so cutting one again can write straight over its old vertexes
+            int array_len = array_mesh->surface_get_array_len(0);
+            Plane recut_plane(Vector3(0, 1, 0), 0.25);
+            Ref<SlicedMesh> recut_expected = Slicer().slice_by_plane(array_mesh, recut_plane, NULL);
+            Ref<SlicedMesh> recut = slicer.slice_by_plane(array_mesh, recut_plane, NULL);
+
+            REQUIRE( recut->lower_mesh == array_mesh );
+            REQUIRE( array_mesh->surface_get_array_len(0) == array_len );
+
+            int expected_len = recut_expected->lower_mesh->surface_get_array_len(0);
+            REQUIRE( expected_len < array_len );
+
+            PoolVector<Vector3> vertexes = array_mesh->surface_get_arrays(0)[Mesh::ARRAY_VERTEX];
+            PoolVector<Vector3> expected_vertexes = recut_expected->lower_mesh->surface_get_arrays(0)[Mesh::ARRAY_VERTEX];
+            PoolVector<Vector3>::Read vertexes_reader = vertexes.read();
+            PoolVector<Vector3>::Read expected_reader = expected_vertexes.read();
+            for (int i = 0; i < expected_len; i++) {
+                REQUIRE( vertexes_reader[i] == expected_reader[i] );
+            }
+
+            // Whatever's left over is collapsed down into triangles with no area
+            for (int i = expected_len; i < array_len; i++) {
+                REQUIRE( vertexes_reader[i] == vertexes_reader[0] );
+            }
+
+            // And left out when it's read back in to be cut again
+            REQUIRE( SlicerFace::faces_from_surface(**array_mesh, 0).size() == expected_len / 3 );
+        }
+    }
+
+    SECTION( "Dicing" ) {
+        Ref<CubeMesh> cube_mesh;
+        cube_mesh.instance();
+        Slicer slicer;
+
+        SECTION( "Cuts a mesh into slabs" ) {
+            Array slabs = slicer.dice(cube_mesh, Vector3(1, 0, 0), 0.5, NULL);
+            REQUIRE( slabs.size() == 4 );
+
+            // The outer slabs only have a cross section on one side
+            Dictionary first_slab = slabs[0];
+            Dictionary second_slab = slabs[1];
+            Ref<ArrayMesh> first = first_slab["mesh"];
+            Ref<ArrayMesh> second = second_slab["mesh"];
+            REQUIRE( first->get_surface_count() == 2 );
+            REQUIRE( first->surface_get_array_len(1) == 6 );
+            REQUIRE( second->surface_get_array_len(1) == 12 );
+            REQUIRE( first->get_aabb().size.x == Approx(0.5) );
+
+            for (int i = 0; i < slabs.size(); i++) {
+                Dictionary slab = slabs[i];
+                REQUIRE( int(slab["index"]) == i - 2 );
+            }
+        }
+
+        SECTION( "Measures slabs from the mesh's origin" ) {
+            Array slabs = slicer.dice(cube_mesh, Vector3(1, 0, 0), 10, NULL);
+            REQUIRE( slabs.size() == 2 );
+
+            Dictionary slab = slabs[1];
+            Ref<ArrayMesh> slab_mesh = slab["mesh"];
+            REQUIRE( int(slab["index"]) == 0 );
+            REQUIRE( slab_mesh->get_aabb().position.x == Approx(0) );
+            REQUIRE( slab_mesh->get_aabb().size.x == Approx(1) );
+        }
+
+        SECTION( "Says which slab each mesh came from when some are empty" ) {
+            // Two triangles with an empty slab between them
+            PoolVector<Vector3> points;
+            points.push_back(Vector3(0.1, 0, 0));
+            points.push_back(Vector3(0.1, 1, 0));
+            points.push_back(Vector3(0.4, 0, 0));
+            points.push_back(Vector3(2.1, 0, 0));
+            points.push_back(Vector3(2.1, 1, 0));
+            points.push_back(Vector3(2.4, 0, 0));
+
+            Array arrays;
+            arrays.resize(Mesh::ARRAY_MAX);
+            arrays[Mesh::ARRAY_VERTEX] = points;
+            Ref<ArrayMesh> gapped_mesh;
+            gapped_mesh.instance();
+            gapped_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+
+            Array slabs = slicer.dice(gapped_mesh, Vector3(1, 0, 0), 1, NULL);
+            REQUIRE( slabs.size() == 2 );
+
+            Dictionary first = slabs[0];
+            Dictionary second = slabs[1];
+            REQUIRE( int(first["index"]) == 0 );
+            REQUIRE( int(second["index"]) == 2 );
+
+            Ref<ArrayMesh> second_mesh = second["mesh"];
+            REQUIRE( second_mesh->get_aabb().position.x == Approx(2.1) );
+        }
+
+        SECTION( "Cuts a mesh into a grid" ) {
+            Array cells = slicer.dice_grid(cube_mesh, Vector3(1, 1, 1), NULL);
+            REQUIRE( cells.size() == 8 );
+
+            for (int i = 0; i < cells.size(); i++) {
+                Dictionary result = cells[i];
+                Ref<ArrayMesh> cell = result["mesh"];
+                REQUIRE( cell->get_surface_count() == 2 );
+                REQUIRE( cell->get_aabb().size == Vector3(1, 1, 1) );
+
+                // Ordered along x first, and each mesh sits in the cell it says it does
+                Vector3 coords = result["cell"];
+                REQUIRE( coords == Vector3(i % 2 - 1, (i / 2) % 2 - 1, i / 4 - 1) );
+                REQUIRE( cell->get_aabb().position == coords );
+            }
+        }
+    }
+
+    SECTION( "Clipping to a convex volume" ) {
+        Ref<CubeMesh> cube_mesh;
+        cube_mesh.instance();
+        Slicer slicer;
+
+        Array planes;
+        planes.push_back(Plane(Vector3(1, 0, 0), 0.5));
+        planes.push_back(Plane(Vector3(-1, 0, 0), 0.5));
+        planes.push_back(Plane(Vector3(0, 1, 0), 0));
+
+        SECTION( "Keeps what's inside every plane" ) {
+            Ref<SlicedMesh> clipped = slicer.clip_to_convex(cube_mesh, planes, NULL);
+            REQUIRE( clipped->upper_mesh.is_null() );
+            REQUIRE( clipped->lower_mesh->get_surface_count() == 2 );
+            REQUIRE( clipped->lower_mesh->get_aabb().position == Vector3(-0.5, -1, -1) );
+            REQUIRE( clipped->lower_mesh->get_aabb().size == Vector3(1, 1, 2) );
+        }
+
+        SECTION( "Can keep what's outside" ) {
+            Ref<SlicedMesh> clipped = slicer.clip_to_convex(cube_mesh, planes, NULL, true);
+            REQUIRE_FALSE( clipped->upper_mesh.is_null() );
+            REQUIRE( clipped->upper_mesh->get_aabb().size == Vector3(2, 2, 2) );
+            REQUIRE( clipped->upper_mesh->surface_get_array_len(1) == clipped->lower_mesh->surface_get_array_len(1) );
+        }
+
+        SECTION( "Leaves nothing if the volume misses the mesh" ) {
+            planes.push_back(Plane(Vector3(0, -1, 0), -5));
+            Ref<SlicedMesh> clipped = slicer.clip_to_convex(cube_mesh, planes, NULL);
+            REQUIRE( clipped->lower_mesh.is_null() );
+        }
+
+        SECTION( "Takes as many planes as it's given" ) {
+            // A prism around a ground quad, with more sides than a clipped triangle keeps inline
+            Ref<PlaneMesh> plane_mesh;
+            plane_mesh.instance();
+
+            Array prism;
+            int side_count = 64;
+            for (int i = 0; i < side_count; i++) {
+                real_t angle = Math_PI * 2 * i / side_count;
+                prism.push_back(Plane(Vector3(Math::cos(angle), 0, Math::sin(angle)), 0.9));
+            }
+
+            Ref<SlicedMesh> clipped = slicer.clip_to_convex(plane_mesh, prism, NULL);
+            REQUIRE_FALSE( clipped->lower_mesh.is_null() );
+
+            // Each half of the quad keeps half of the prism's corners plus two on its diagonal
+            REQUIRE( clipped->lower_mesh->surface_get_array_len(0) == 2 * (side_count / 2) * 3 );
+            REQUIRE( clipped->lower_mesh->get_aabb().size.x == Approx(1.8) );
+            REQUIRE( clipped->lower_mesh->get_aabb().size.z == Approx(1.8) );
+        }
+    }
+
+    SECTION( "Shattering" ) {
+        Ref<CubeMesh> cube_mesh;
+        cube_mesh.instance();
+        Slicer slicer;
+
+        PoolVector<Vector3> seeds;
+        seeds.push_back(Vector3(-0.5, -0.5, 0));
+        seeds.push_back(Vector3(0.5, -0.5, 0));
+        seeds.push_back(Vector3(0, 0.5, 0));
+
+        SECTION( "Splits a mesh into a cell per seed" ) {
+            Array cells = slicer.shatter(cube_mesh, seeds, NULL);
+            REQUIRE( cells.size() == 3 );
+
+            // The first two seeds only differ along x, so they're split down the middle
+            Ref<ArrayMesh> first = cells[0];
+            REQUIRE( first->get_surface_count() == 2 );
+            REQUIRE( first->get_aabb().position.x == Approx(-1) );
+            REQUIRE( first->get_aabb().size.x == Approx(1) );
+        }
+
+        SECTION( "Leaves a null for cells that miss the mesh" ) {
+            // The empty cell comes before the last seed's, which still has to line up with it
+            seeds.insert(2, Vector3(10, 0, 0));
+            Array cells = slicer.shatter(cube_mesh, seeds, NULL);
+            REQUIRE( cells.size() == 4 );
+            REQUIRE( cells[2].get_type() == Variant::NIL );
+
+            Ref<ArrayMesh> last = cells[3];
+            REQUIRE_FALSE( last.is_null() );
+            REQUIRE( last->get_aabb().position.y == Approx(-0.125) );
+        }
+
+        SECTION( "Only keeps one of two seeds in the same place" ) {
+            seeds.push_back(Vector3(0, 0.5, 0));
+            Array cells = slicer.shatter(cube_mesh, seeds, NULL);
+            REQUIRE( cells.size() == 4 );
+            REQUIRE_FALSE( cells[2].get_type() == Variant::NIL );
+            REQUIRE( cells[3].get_type() == Variant::NIL );
+        }
+    }
+
+    SECTION( "Slicing a scene" ) {
+        Ref<SphereMesh> sphere_mesh;
+        sphere_mesh.instance();
+
+        SceneTree *tree = memnew(SceneTree);
+        tree->init();
+        Spatial *root = memnew(Spatial);
+        tree->get_root()->add_child(root);
+        Slicer *slicer = memnew(Slicer);
+        root->add_child(slicer);
+
+        // Only the first of these should be cut by a plane at x = 0.5
+        MeshInstance *crossing = add_mesh_instance(root, sphere_mesh, Vector3(0, 0, 0));
+        add_mesh_instance(root, sphere_mesh, Vector3(5, 0, 0));
+        add_mesh_instance(root, sphere_mesh, Vector3(0, 0, 5))->set_layer_mask(2);
+        add_mesh_instance(tree->get_root(), sphere_mesh, Vector3(0, 0, -5));
+
+        SECTION( "Cuts the instances under the root that the plane passes through" ) {
+            // Not normalized, but still the plane at x = 0.5
+            Array results = slicer->slice_scene(root, Plane(Vector3(2, 0, 0), 1), NULL, 1);
+            REQUIRE( results.size() == 1 );
+
+            Dictionary result = results[0];
+            Object *instance = result["instance"];
+            REQUIRE( instance == crossing );
+
+            Ref<SlicedMesh> sliced_mesh = result["sliced_mesh"];
+            REQUIRE_FALSE( sliced_mesh.is_null() );
+            REQUIRE( sliced_mesh->lower_mesh->get_aabb().get_end().x == Approx(0.5) );
+            REQUIRE( sliced_mesh->upper_mesh->get_aabb().position.x == Approx(0.5) );
+        }
+
+        SECTION( "Looks at every layer in the mask" ) {
+            Array results = slicer->slice_scene(root, Plane(Vector3(1, 0, 0), 0.5), NULL, 3);
+            REQUIRE( results.size() == 2 );
+        }
+
+        SECTION( "Returns nothing if the plane misses everything" ) {
+            Array results = slicer->slice_scene(root, Plane(Vector3(0, 1, 0), 10), NULL);
+            REQUIRE( results.size() == 0 );
+        }
+
+        SECTION( "Doesn't write back into meshes shared between instances" ) {
+            Ref<ArrayMesh> array_mesh;
+            array_mesh.instance();
+            array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, sphere_mesh->surface_get_arrays(0));
+            crossing->set_mesh(array_mesh);
+            add_mesh_instance(root, array_mesh, Vector3(0, 0, -2));
+
+            slicer->set_update_in_place(true);
+            Array results = slicer->slice_scene(root, Plane(Vector3(1, 0, 0), 0.5), NULL, 1);
+            REQUIRE( results.size() == 2 );
+            for (int i = 0; i < results.size(); i++) {
+                Dictionary result = results[i];
+                Ref<SlicedMesh> sliced_mesh = result["sliced_mesh"];
+                REQUIRE( sliced_mesh->lower_mesh != array_mesh );
+                REQUIRE( sliced_mesh->upper_mesh != array_mesh );
+            }
+            REQUIRE( array_mesh->get_aabb().get_end().x == Approx(1) );
+        }
+
+        tree->finish();
+        memdelete(tree);
+    }
+
+    SECTION( "Slicing on worker threads" ) {
+        Ref<SphereMesh> sphere_mesh;
+        sphere_mesh.instance();
+        Slicer slicer;
+        Ref<SlicedMesh> serial = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+
+        WorkerPool pool(3);
+        WorkerPool::set_singleton(&pool);
+        Ref<SlicedMesh> sliced_mesh = slicer.slice_by_plane(sphere_mesh, plane, NULL);
+        Ref<SlicedMesh> missed = slicer.slice_by_plane(sphere_mesh, Plane(Vector3(1, 0, 0), 10), NULL);
+        WorkerPool::set_singleton(NULL);
+
+        REQUIRE( missed.is_null() );
+        REQUIRE_FALSE( sliced_mesh.is_null() );
+        REQUIRE( sliced_mesh->upper_mesh->get_surface_count() == serial->upper_mesh->get_surface_count() );
+        REQUIRE( sliced_mesh->lower_mesh->get_surface_count() == serial->lower_mesh->get_surface_count() );
+        for (int i = 0; i < serial->upper_mesh->get_surface_count(); i++) {
+            REQUIRE( sliced_mesh->upper_mesh->surface_get_array_len(i) == serial->upper_mesh->surface_get_array_len(i) );
+            REQUIRE( sliced_mesh->lower_mesh->surface_get_array_len(i) == serial->lower_mesh->surface_get_array_len(i) );
+        }
+    }
 }
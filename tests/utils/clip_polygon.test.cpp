@@ -0,0 +1,99 @@
+#include "../catch.hpp"
+#include "../../utils/clip_polygon.h"
+
+TEST_CASE( "[ClipPolygon]" ) {
+    SlicerFace face(Vector3(0, 0, 0), Vector3(0, 2, 0), Vector3(2, 0, 0));
+    face.set_uvs(Vector2(0, 0), Vector2(0, 1), Vector2(1, 0));
+    face.source_index[0] = 0;
+    face.source_index[1] = 1;
+    face.source_index[2] = 2;
+
+    ClipPolygon polygon = ClipPolygon::from_face(face);
+    REQUIRE( polygon.count == 3 );
+    REQUIRE( polygon.has_uvs );
+    REQUIRE_FALSE( polygon.has_normals );
+
+    SECTION( "Splits into the parts above and below a plane" ) {
+        ClipPolygon upper;
+        ClipPolygon lower;
+        Vector<Vector3> points;
+        polygon.split(Plane(Vector3(0, 1, 0), 1), upper, lower, &points);
+
+        REQUIRE( upper.count == 3 );
+        REQUIRE( lower.count == 4 );
+        REQUIRE( points.size() == 2 );
+        REQUIRE( points[0] == Vector3(0, 1, 0) );
+        REQUIRE( points[1] == Vector3(1, 1, 0) );
+
+        REQUIRE( upper.get_vertex(0).vertex == Vector3(0, 1, 0) );
+        REQUIRE( upper.get_vertex(0).uv == Vector2(0, 0.5) );
+        REQUIRE( upper.get_vertex(0).source_index == -1 );
+        REQUIRE( upper.get_vertex(1).source_index == 1 );
+    }
+
+    SECTION( "Leaves a side empty if nothing falls on it" ) {
+        ClipPolygon upper;
+        ClipPolygon lower;
+        Vector<Vector3> points;
+
+        polygon.split(Plane(Vector3(0, 1, 0), 5), upper, lower, &points);
+        REQUIRE( upper.is_empty() );
+        REQUIRE( lower.count == 3 );
+        REQUIRE( points.size() == 0 );
+
+        // Touching the plane doesn't count as being on the other side of it
+        polygon.split(Plane(Vector3(0, 1, 0), 0), upper, lower, &points);
+        REQUIRE( upper.count == 3 );
+        REQUIRE( lower.is_empty() );
+        REQUIRE( points.size() == 2 );
+    }
+
+    SECTION( "Can be clipped by several planes before being triangulated" ) {
+        ClipPolygon clipped;
+        polygon.clip(Plane(Vector3(0, 1, 0), 1), clipped);
+        polygon = clipped;
+        polygon.clip(Plane(Vector3(1, 0, 0), 1), clipped);
+        REQUIRE( clipped.count == 4 );
+
+        Vector<SlicerFace> faces;
+        clipped.triangulate(faces);
+        REQUIRE( faces.size() == 2 );
+        REQUIRE( faces[0].has_uvs );
+        REQUIRE( faces[0].vertex[0] == Vector3(0, 0, 0) );
+        REQUIRE( faces[0].vertex[1] == Vector3(0, 1, 0) );
+        REQUIRE( faces[0].vertex[2] == Vector3(1, 1, 0) );
+        REQUIRE( faces[0].source_index[0] == 0 );
+
+        Vector<SlicerFace> reversed;
+        clipped.triangulate(reversed, true);
+        REQUIRE( reversed[0].vertex[1] == Vector3(1, 1, 0) );
+        REQUIRE( reversed[0].vertex[2] == Vector3(0, 1, 0) );
+    }
+
+    SECTION( "Can be clipped by more planes than it keeps inline" ) {
+        // Cutting out a circle, so every plane adds a vertex
+        SlicerFace big_face(Vector3(0, 0, 0), Vector3(0, 100, 0), Vector3(100, 0, 0));
+        ClipPolygon clipped = ClipPolygon::from_face(big_face);
+        Vector3 center(25, 25, 0);
+
+        int plane_count = 48;
+        for (int i = 0; i < plane_count; i++) {
+            real_t angle = Math_PI * 2 * i / plane_count;
+            Vector3 normal(Math::cos(angle), Math::sin(angle), 0);
+
+            ClipPolygon inside;
+            clipped.clip(Plane(normal, normal.dot(center) + 10), inside);
+            clipped = inside;
+        }
+
+        REQUIRE( clipped.count == plane_count );
+        REQUIRE( clipped.count > ClipPolygon::MAX_INLINE_VERTEXES );
+        for (int i = 0; i < clipped.count; i++) {
+            REQUIRE( (clipped.get_vertex(i).vertex - center).length() == Approx(10 / Math::cos(Math_PI / plane_count)) );
+        }
+
+        Vector<SlicerFace> faces;
+        clipped.triangulate(faces);
+        REQUIRE( faces.size() == plane_count - 2 );
+    }
+}
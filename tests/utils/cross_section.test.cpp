@@ -0,0 +1,100 @@
+#include "../catch.hpp"
+#include "../../utils/cross_section.h"
+
+/**
+ * The faces of an axis aligned box, wound clockwise when seen from outside
+ * of it (or from inside of it, if inside_out is set)
+*/
+PoolVector<Face3> make_box(const Vector3 &lo, const Vector3 &hi, bool inside_out) {
+    Vector3 corners[8];
+    for (int i = 0; i < 8; i++) {
+        corners[i] = Vector3(i & 1 ? hi.x : lo.x, i & 2 ? hi.y : lo.y, i & 4 ? hi.z : lo.z);
+    }
+
+    int quads[6][4] = { { 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 } };
+
+    PoolVector<Face3> faces;
+    for (int i = 0; i < 6; i++) {
+        const int *quad = quads[i];
+        for (int j = 0; j < 2; j++) {
+            Vector3 a = corners[quad[0]];
+            Vector3 b = corners[quad[j + 2]];
+            Vector3 c = corners[quad[j + 1]];
+            faces.push_back(inside_out ? Face3(a, c, b) : Face3(a, b, c));
+        }
+    }
+
+    return faces;
+}
+
+TEST_CASE( "[cross_section]" ) {
+    PoolVector<Face3> box = make_box(Vector3(-1, -1, -1), Vector3(1, 1, 1), false);
+
+    SECTION( "cross_face" ) {
+        Vector3 from;
+        Vector3 to;
+
+        SECTION( "finds where the plane crosses a face" ) {
+            REQUIRE( CrossSection::cross_face(Plane(Vector3(0, 1, 0), 0.5), box[0], from, to) );
+            REQUIRE( from.y == Approx(0.5) );
+            REQUIRE( to.y == Approx(0.5) );
+        }
+
+        SECTION( "ignores faces the plane misses or only touches" ) {
+            REQUIRE_FALSE( CrossSection::cross_face(Plane(Vector3(0, 1, 0), 5), box[0], from, to) );
+            REQUIRE_FALSE( CrossSection::cross_face(Plane(Vector3(0, 0, 1), -1), box[0], from, to) );
+        }
+    }
+
+    SECTION( "find_loops" ) {
+        SECTION( "joins the crossings up into a loop" ) {
+            Plane plane(Vector3(0, 0, 1), 0.25);
+            Vector<CrossSection::Loop> loops = CrossSection::find_loops(box, plane);
+            REQUIRE( loops.size() == 1 );
+            REQUIRE( loops[0].is_closed );
+            REQUIRE( loops[0].area(plane.normal) == Approx(4) );
+            REQUIRE( loops[0].length() == Approx(8) );
+        }
+
+        SECTION( "winds the same way for planes facing the other way" ) {
+            Plane plane(Vector3(0, 0, -1), 0.25);
+            Vector<CrossSection::Loop> loops = CrossSection::find_loops(box, plane);
+            REQUIRE( loops.size() == 1 );
+            REQUIRE( loops[0].area(plane.normal) == Approx(4) );
+        }
+
+        SECTION( "handles planes passing through corners" ) {
+            Plane plane(Vector3(1, 1, 0).normalized(), 0);
+            Vector<CrossSection::Loop> loops = CrossSection::find_loops(box, plane);
+            REQUIRE( loops.size() == 1 );
+            REQUIRE( loops[0].is_closed );
+            REQUIRE( loops[0].area(plane.normal) == Approx(4 * Math_SQRT2) );
+        }
+
+        SECTION( "gives holes a negative area" ) {
+            PoolVector<Face3> hollow = box;
+            PoolVector<Face3> inside = make_box(Vector3(-0.5, -0.5, -0.5), Vector3(0.5, 0.5, 0.5), true);
+            for (int i = 0; i < inside.size(); i++) {
+                hollow.push_back(inside[i]);
+            }
+
+            Plane plane(Vector3(0, 0, 1), 0);
+            Vector<CrossSection::Loop> loops = CrossSection::find_loops(hollow, plane);
+            REQUIRE( loops.size() == 2 );
+            REQUIRE( loops[0].area(plane.normal) + loops[1].area(plane.normal) == Approx(3) );
+        }
+
+        SECTION( "leaves the loops of open meshes open" ) {
+            PoolVector<Face3> open_box = box;
+            open_box.remove(open_box.size() - 1);
+            open_box.remove(open_box.size() - 1);
+
+            Plane plane(Vector3(0, 0, 1), 0);
+            Vector<CrossSection::Loop> loops = CrossSection::find_loops(open_box, plane);
+            REQUIRE( loops.size() == 1 );
+            REQUIRE_FALSE( loops[0].is_closed );
+            REQUIRE( loops[0].points.size() == 7 );
+            REQUIRE( loops[0].area(plane.normal) == 0 );
+        }
+    }
+}
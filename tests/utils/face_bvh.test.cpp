@@ -0,0 +1,48 @@
+#include "../catch.hpp"
+#include "../../utils/face_bvh.h"
+#include "scene/resources/primitive_meshes.h"
+
+TEST_CASE( "[face_bvh]" ) {
+    SphereMesh sphere_mesh;
+    Vector<SlicerFace> faces = SlicerFace::faces_from_surface(sphere_mesh, 0);
+
+    FaceBVH bvh;
+    REQUIRE_FALSE( bvh.is_built() );
+    bvh.build(faces);
+    REQUIRE( bvh.is_built() );
+
+    SECTION( "keeps every face" ) {
+        REQUIRE( faces.size() == 4224 );
+        REQUIRE( bvh.nodes[0].start == 0 );
+        REQUIRE( bvh.nodes[0].count == faces.size() );
+
+        for (int i = 0; i < bvh.nodes.size(); i++) {
+            const FaceBVH::Node &node = bvh.nodes[i];
+            if (node.left < 0) {
+                REQUIRE( node.count <= FaceBVH::MAX_LEAF_FACES );
+            } else {
+                REQUIRE( bvh.nodes[node.left].start == node.start );
+                REQUIRE( bvh.nodes[node.left].count + bvh.nodes[node.right].count == node.count );
+            }
+        }
+    }
+
+    SECTION( "splits the same as going face by face" ) {
+        Plane plane(Vector3(0, 1, 0), 0);
+        Intersector::SplitResult result;
+        bvh.split_by_plane(plane, faces, result);
+
+        REQUIRE( result.lower_faces.size() == 2240 );
+        REQUIRE( result.upper_faces.size() == 2240 );
+        REQUIRE( result.intersection_points.size() == 256 );
+    }
+
+    SECTION( "passes along faces that aren't cut" ) {
+        Intersector::SplitResult result;
+        bvh.split_by_plane(Plane(Vector3(0, 1, 0), 10), faces, result);
+
+        REQUIRE( result.lower_faces.size() == faces.size() );
+        REQUIRE( result.upper_faces.size() == 0 );
+        REQUIRE( result.intersection_points.size() == 0 );
+    }
+}
@@ -19,12 +19,51 @@ TEST_CASE( "[get_side_of]" ) {
     }
 }
 
+TEST_CASE( "[AxisPlane]" ) {
+    SECTION( "Recognizes axis aligned planes" ) {
+        Intersector::AxisPlane axis_plane;
+        REQUIRE( Intersector::AxisPlane::from_plane(Plane(Vector3(0, -1, 0), 2), axis_plane) );
+        REQUIRE( axis_plane.axis == 1 );
+        REQUIRE( axis_plane.sign == -1 );
+        REQUIRE( axis_plane.d == 2 );
+        REQUIRE( axis_plane.to_plane() == Plane(Vector3(0, -1, 0), 2) );
+        REQUIRE( axis_plane.distance_to(Vector3(5, -3, 5)) == 1 );
+
+        REQUIRE( Intersector::AxisPlane::from_plane(Plane(Vector3(0.0000001, 0, 1), 0), axis_plane) );
+        REQUIRE( axis_plane.axis == 2 );
+
+        REQUIRE_FALSE( Intersector::AxisPlane::from_plane(Plane(Vector3(1, 1, 0).normalized(), 0), axis_plane) );
+    }
+
+    SECTION( "Splits the same as a regular plane" ) {
+        SphereMesh sphere_mesh;
+        Vector<SlicerFace> faces = SlicerFace::faces_from_surface(sphere_mesh, 0);
+        Plane plane(Vector3(0, 1, 0), 0.3);
+        Intersector::AxisPlane axis_plane;
+        REQUIRE( Intersector::AxisPlane::from_plane(plane, axis_plane) );
+
+        Intersector::SplitResult expected;
+        Intersector::SplitResult result;
+        for (int i = 0; i < faces.size(); i++) {
+            Intersector::split_face_by_plane(plane, faces[i], expected);
+            Intersector::split_face_by_plane(axis_plane, faces[i], result);
+        }
+
+        REQUIRE( result.upper_faces.size() == expected.upper_faces.size() );
+        REQUIRE( result.lower_faces.size() == expected.lower_faces.size() );
+        REQUIRE( result.intersection_points.size() == expected.intersection_points.size() );
+        for (int i = 0; i < result.intersection_points.size(); i++) {
+            REQUIRE( result.intersection_points[i] == expected.intersection_points[i] );
+        }
+    }
+}
+
 TEST_CASE( "[split_face_by_plane]") {
     Plane plane(Vector3(0, 1, 0), 0);
 
     SECTION( "Smoke test") {
         SphereMesh sphere_mesh;
-        PoolVector<SlicerFace> faces = SlicerFace::faces_from_surface(sphere_mesh, 0);
+        Vector<SlicerFace> faces = SlicerFace::faces_from_surface(sphere_mesh, 0);
         REQUIRE( faces.size() == 4224 );
         Intersector::SplitResult result;
         for (int i = 0; i < faces.size(); i++) {
@@ -113,6 +152,18 @@ TEST_CASE( "[split_face_by_plane]") {
             REQUIRE( result.upper_faces[0] == SlicerFace(Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, 0)) );
             REQUIRE( result.lower_faces[0] == SlicerFace(Vector3(1, 0, 0), Vector3(0, 0, 0), Vector3(0, -1, 0)) );
         }
+
+        SECTION("point after the one on the plane is below") {
+            Intersector::SplitResult result;
+            Intersector::split_face_by_plane(plane, SlicerFace(Vector3(0, 0, 0), Vector3(1, -1, 0), Vector3(1, 1, 0)), result);
+            REQUIRE( result.upper_faces.size() == 1 );
+            REQUIRE( result.lower_faces.size() == 1 );
+            REQUIRE( result.intersection_points.size() == 2 );
+            REQUIRE( result.intersection_points[0] == Vector3(0, 0, 0) );
+            REQUIRE( result.intersection_points[1] == Vector3(1, 0, 0) );
+            REQUIRE( result.upper_faces[0] == SlicerFace(Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(1, 1, 0)) );
+            REQUIRE( result.lower_faces[0] == SlicerFace(Vector3(0, 0, 0), Vector3(1, -1, 0), Vector3(1, 0, 0)) );
+        }
     }
 
     SECTION( "full_split") {
@@ -152,5 +203,54 @@ TEST_CASE( "[split_face_by_plane]") {
             REQUIRE( result.lower_faces[0] == SlicerFace(Vector3(2, -1, 0), Vector3(0.5, 0, 0), Vector3(1.5, 0, 0)) );
             REQUIRE( result.lower_faces[1] == SlicerFace(Vector3(0, -1, 0), Vector3(0.5, 0, 0), Vector3(2, -1, 0)) );
         }
+        SECTION("keeps track of which vertexes came from the source surface") {
+            SlicerFace face(Vector3(1, 1, 0), Vector3(2, -1, 0), Vector3(0, -1, 0));
+            face.source_index[0] = 10;
+            face.source_index[1] = 11;
+            face.source_index[2] = 12;
+
+            Intersector::SplitResult result;
+            Intersector::split_face_by_plane(plane, face, result);
+            REQUIRE( result.upper_faces[0].source_index[0] == 10 );
+            REQUIRE( result.upper_faces[0].source_index[1] == -1 );
+            REQUIRE( result.upper_faces[0].source_index[2] == -1 );
+            REQUIRE( result.lower_faces[1].source_index[0] == 12 );
+            REQUIRE( result.lower_faces[1].source_index[2] == 11 );
+        }
+    }
+
+    SECTION( "Only keeps the sides it's asked to" ) {
+        Intersector::SplitResult result;
+        result.keep_upper = false;
+
+        Intersector::split_face_by_plane(plane, SlicerFace(Vector3(1, 1, 0), Vector3(2, -1, 0), Vector3(0, -1, 0)), result);
+        Intersector::split_face_by_plane(plane, SlicerFace(Vector3(0, 1, 0), Vector3(1, 2, 0), Vector3(2, 1, 0)), result);
+        REQUIRE( result.upper_faces.size() == 0 );
+        REQUIRE( result.lower_faces.size() == 2 );
+
+        // The cross section still needs the points from the discarded side
+        REQUIRE( result.intersection_points.size() == 2 );
+    }
+
+    SECTION( "Resets everything it collected" ) {
+        PoolVector<uint8_t> source_buffer;
+        source_buffer.resize(12);
+
+        Intersector::SplitResult result;
+        result.shared_vertex_array = source_buffer;
+        result.shared_format = Mesh::ARRAY_FORMAT_VERTEX;
+        result.shared_vertex_count = 1;
+        Intersector::split_face_by_plane(plane, SlicerFace(Vector3(1, 1, 0), Vector3(2, -1, 0), Vector3(0, -1, 0)), result);
+
+        result.reset();
+        REQUIRE( result.upper_faces.size() == 0 );
+        REQUIRE( result.lower_faces.size() == 0 );
+        REQUIRE( result.intersection_points.size() == 0 );
+        REQUIRE( result.shared_vertex_array.size() == 0 );
+        REQUIRE( result.shared_format == 0 );
+        REQUIRE( result.shared_vertex_count == 0 );
+
+        // The source's buffer is let go of rather than being emptied
+        REQUIRE( source_buffer.size() == 12 );
     }
 }
@@ -0,0 +1,56 @@
+#include "../catch.hpp"
+#include "../../utils/projection_index.h"
+#include "scene/resources/primitive_meshes.h"
+
+TEST_CASE( "[projection_index]" ) {
+    SphereMesh sphere_mesh;
+    Vector<SlicerFace> faces = SlicerFace::faces_from_surface(sphere_mesh, 0);
+
+    PoolVector<Vector3> directions;
+    directions.push_back(Vector3(0, 1, 0));
+    directions.push_back(Vector3(1, 0, 0));
+
+    ProjectionIndex index;
+    REQUIRE_FALSE( index.is_built() );
+    index.build(faces, directions);
+    REQUIRE( index.is_built() );
+    REQUIRE( index.axes.size() == 2 );
+
+    SECTION( "keeps faces sorted" ) {
+        const ProjectionIndex::Axis &axis = index.axes[0];
+        REQUIRE( axis.order.size() == faces.size() );
+        for (int i = 1; i < axis.mins.size(); i++) {
+            REQUIRE( axis.mins[i - 1] <= axis.mins[i] );
+        }
+    }
+
+    SECTION( "splits the same as going face by face" ) {
+        Intersector::SplitResult result;
+        REQUIRE( index.split_by_plane(Plane(Vector3(0, 1, 0), 0), faces, result) );
+
+        REQUIRE( result.lower_faces.size() == 2240 );
+        REQUIRE( result.upper_faces.size() == 2240 );
+        REQUIRE( result.intersection_points.size() == 256 );
+    }
+
+    SECTION( "handles planes facing the other way" ) {
+        Intersector::SplitResult result;
+        REQUIRE( index.split_by_plane(Plane(Vector3(0, -1, 0), -0.25), faces, result) );
+
+        Intersector::SplitResult expected;
+        for (int i = 0; i < faces.size(); i++) {
+            Intersector::split_face_by_plane(Plane(Vector3(0, -1, 0), -0.25), faces[i], expected);
+        }
+
+        REQUIRE( result.lower_faces.size() == expected.lower_faces.size() );
+        REQUIRE( result.upper_faces.size() == expected.upper_faces.size() );
+        REQUIRE( result.intersection_points.size() == expected.intersection_points.size() );
+    }
+
+    SECTION( "ignores planes that don't match a direction" ) {
+        Intersector::SplitResult result;
+        REQUIRE_FALSE( index.split_by_plane(Plane(Vector3(0, 0, 1), 0), faces, result) );
+        REQUIRE( result.lower_faces.size() == 0 );
+        REQUIRE( result.upper_faces.size() == 0 );
+    }
+}
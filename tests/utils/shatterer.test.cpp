@@ -0,0 +1,36 @@
+#include "../catch.hpp"
+#include "../../utils/shatterer.h"
+
+TEST_CASE( "[Shatterer]" ) {
+    AABB bounds(Vector3(-1, -1, -1), Vector3(2, 2, 2));
+    Vector<Vector3> seeds;
+    seeds.push_back(Vector3(-0.5, 0, 0));
+    seeds.push_back(Vector3(0.5, 0, 0));
+
+    SECTION( "Bounds each cell by the bisectors with every other seed" ) {
+        Vector<Plane> planes;
+        REQUIRE( Shatterer::get_cell_planes(seeds, 0, bounds, planes) );
+        REQUIRE( planes.size() == 1 );
+        REQUIRE( planes[0] == Plane(Vector3(1, 0, 0), 0) );
+
+        REQUIRE( Shatterer::get_cell_planes(seeds, 1, bounds, planes) );
+        REQUIRE( planes.size() == 1 );
+        REQUIRE( planes[0] == Plane(Vector3(-1, 0, 0), 0) );
+    }
+
+    SECTION( "Leaves out bisectors that can't cut anything" ) {
+        seeds.push_back(Vector3(10, 0, 0));
+
+        Vector<Plane> planes;
+        REQUIRE( Shatterer::get_cell_planes(seeds, 0, bounds, planes) );
+        REQUIRE( planes.size() == 1 );
+    }
+
+    SECTION( "Gives seeds in the same place to whichever came first" ) {
+        seeds.push_back(Vector3(-0.5, 0, 0));
+
+        Vector<Plane> planes;
+        REQUIRE( Shatterer::get_cell_planes(seeds, 0, bounds, planes) );
+        REQUIRE_FALSE( Shatterer::get_cell_planes(seeds, 2, bounds, planes) );
+    }
+}
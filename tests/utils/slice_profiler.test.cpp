@@ -0,0 +1,55 @@
+#include "../catch.hpp"
+#include "../../utils/slice_profiler.h"
+#include "core/os/dir_access.h"
+#include "core/os/os.h"
+
+TEST_CASE( "[SliceProfiler]" ) {
+    // Scopes report to the singleton, so ours stands in for the module's while we're testing
+    SliceProfiler *module_profiler = SliceProfiler::get_singleton();
+    SliceProfiler profiler;
+    SliceProfiler::set_singleton(&profiler);
+
+    String path = OS::get_singleton()->get_cache_path().plus_file("slice_profiler.test.json");
+
+    SECTION( "Writes spans out as Chrome trace events" ) {
+        REQUIRE( profiler.start_trace(path) == OK );
+        REQUIRE( profiler.is_tracing() );
+        {
+            SliceProfileScope scope("split", "Cube", 2);
+            scope.set_triangles(12);
+        }
+        REQUIRE( profiler.stop_trace() == OK );
+        REQUIRE_FALSE( profiler.is_tracing() );
+
+        String trace = FileAccess::get_file_as_string(path);
+        REQUIRE( trace.find("{\"traceEvents\":[") == 0 );
+        REQUIRE( trace.find("\"name\":\"split\"") != -1 );
+        REQUIRE( trace.find("\"mesh\":\"Cube\",\"surface\":2,\"triangles\":12") != -1 );
+        REQUIRE( trace.find("\"name\":\"Main thread\"") != -1 );
+    }
+
+    SECTION( "Only keeps spans while a trace is running" ) {
+        {
+            SliceProfileScope scope("cap", "Cube");
+        }
+        REQUIRE( profiler.start_trace(path) == OK );
+        REQUIRE( profiler.stop_trace() == OK );
+        {
+            SliceProfileScope scope("build", "Cube");
+        }
+
+        String trace = FileAccess::get_file_as_string(path);
+        REQUIRE( trace.find("\"cap\"") == -1 );
+        REQUIRE( trace.find("\"build\"") == -1 );
+    }
+
+    SECTION( "Only runs one trace at a time" ) {
+        REQUIRE( profiler.stop_trace() == ERR_UNAVAILABLE );
+        REQUIRE( profiler.start_trace(path) == OK );
+        REQUIRE( profiler.start_trace(path) == ERR_BUSY );
+        REQUIRE( profiler.stop_trace() == OK );
+    }
+
+    DirAccess::remove_file_or_error(path);
+    SliceProfiler::set_singleton(module_profiler);
+}
@@ -47,7 +47,7 @@ TEST_CASE( "[SlicerFace]" ) {
         SECTION( "Parses faces similar to built in method") {
             SphereMesh sphere_mesh;
             auto control_faces = sphere_mesh.get_faces();
-            PoolVector<SlicerFace> faces = SlicerFace::faces_from_surface(sphere_mesh, 0);
+            Vector<SlicerFace> faces = SlicerFace::faces_from_surface(sphere_mesh, 0);
             REQUIRE( faces.size() == control_faces.size() );
             for (int i = 0; i < faces.size(); i++) {
                 REQUIRE( faces[i] == control_faces[i] );
@@ -58,7 +58,7 @@ TEST_CASE( "[SlicerFace]" ) {
             ArrayMesh array_mesh;
             Array arrays = make_test_array(3);
             array_mesh.add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
-            PoolVector<SlicerFace> faces = SlicerFace::faces_from_surface(array_mesh, 0);
+            Vector<SlicerFace> faces = SlicerFace::faces_from_surface(array_mesh, 0);
             REQUIRE( faces.size() == 3 );
 
             PoolVector<Vector3> points = arrays[Mesh::ARRAY_VERTEX];
@@ -91,6 +91,30 @@ TEST_CASE( "[SlicerFace]" ) {
             }
         }
 
+        SECTION( "Only leaves out padding written by an in place update") {
+            // A triangle with no area in the middle, then two copies of the first vertex at the end
+            PoolVector<Vector3> points;
+            Vector3 corners[4] = { Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(1, 0, 0), Vector3(2, 2, 2) };
+            int corner_idxs[15] = { 0, 1, 2, 3, 3, 3, 2, 1, 3, 0, 0, 0, 0, 0, 0 };
+            for (int i = 0; i < 15; i++) {
+                points.push_back(corners[corner_idxs[i]]);
+            }
+
+            Array arrays;
+            arrays.resize(Mesh::ARRAY_MAX);
+            arrays[Mesh::ARRAY_VERTEX] = points;
+
+            ArrayMesh array_mesh;
+            array_mesh.add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+            Vector<SlicerFace> faces = SlicerFace::faces_from_surface(array_mesh, 0);
+            REQUIRE( faces.size() == 3 );
+            REQUIRE( faces[1].vertex[0] == Vector3(2, 2, 2) );
+            REQUIRE( faces[2].vertex[2] == Vector3(2, 2, 2) );
+
+            // Arrays straight from a script are never padded, so nothing is left out of them
+            REQUIRE( SlicerFace::faces_from_arrays(arrays).size() == 5 );
+        }
+
         SECTION( "With indexed arrays") {
             ArrayMesh array_mesh;
             Array arrays = make_test_array(24);
@@ -102,7 +126,7 @@ TEST_CASE( "[SlicerFace]" ) {
 
             arrays[Mesh::ARRAY_INDEX] = indices;
             array_mesh.add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
-            PoolVector<SlicerFace> faces = SlicerFace::faces_from_surface(array_mesh, 0);
+            Vector<SlicerFace> faces = SlicerFace::faces_from_surface(array_mesh, 0);
             REQUIRE( faces.size() == 3 );
 
             PoolVector<Vector3> points = arrays[Mesh::ARRAY_VERTEX];
@@ -131,6 +155,7 @@ TEST_CASE( "[SlicerFace]" ) {
                 REQUIRE( faces[face].tangent[i % 3][3] == tangents[(idxs[i] * 4) + 3] );
 
                 REQUIRE( faces[face].uv[i % 3] == uvs[idxs[i]] );
+                REQUIRE( faces[face].source_index[i % 3] == idxs[i] );
             }
         }
     }
@@ -160,6 +185,9 @@ TEST_CASE( "[SlicerFace]" ) {
     SECTION("sub_face") {
         SlicerFace face(Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(0, 1, 1));
         face.set_uvs(Vector2(0, 0), Vector2(1, 0), Vector2(1, 1));
+        face.source_index[0] = 3;
+        face.source_index[1] = 4;
+        face.source_index[2] = 5;
         SlicerFace sub_face = face.sub_face(Vector3(0, 0, 0), Vector3(0, 0.5, 0), Vector3(0, 0.5, 0.5));
         REQUIRE(sub_face.vertex[0] == Vector3(0, 0, 0));
         REQUIRE(sub_face.vertex[1] == Vector3(0, 0.5, 0));
@@ -170,6 +198,11 @@ TEST_CASE( "[SlicerFace]" ) {
         REQUIRE(sub_face.uv[1] == Vector2(0.5, 0));
         REQUIRE(sub_face.uv[2] == Vector2(0.5, 0.5));
 
+        // Only the point that was carried over still refers to the original surface
+        REQUIRE(sub_face.source_index[0] == 3);
+        REQUIRE(sub_face.source_index[1] == -1);
+        REQUIRE(sub_face.source_index[2] == -1);
+
         REQUIRE_FALSE(sub_face.has_normals);
         REQUIRE_FALSE(sub_face.has_tangents);
         REQUIRE_FALSE(sub_face.has_colors);
@@ -178,6 +211,34 @@ TEST_CASE( "[SlicerFace]" ) {
         REQUIRE_FALSE(sub_face.has_weights);
     }
 
+    SECTION("set_vertex_from") {
+        SlicerFace face(Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(0, 1, 1));
+        face.set_uvs(Vector2(0, 0), Vector2(1, 0), Vector2(1, 1));
+        face.source_index[2] = 5;
+
+        SlicerFace copy;
+        copy.set_vertex_from(0, face, 2);
+        REQUIRE(copy.vertex[0] == Vector3(0, 1, 1));
+        REQUIRE(copy.has_uvs);
+        REQUIRE(copy.uv[0] == Vector2(1, 1));
+        REQUIRE(copy.source_index[0] == 5);
+        REQUIRE_FALSE(copy.has_normals);
+    }
+
+    SECTION("set_vertex_between") {
+        SlicerFace face(Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(0, 1, 1));
+        face.set_uvs(Vector2(0, 0), Vector2(1, 0), Vector2(1, 1));
+        face.source_index[0] = 3;
+        face.source_index[1] = 4;
+
+        SlicerFace cut;
+        cut.set_vertex_between(1, face, 0, 1, 0.5);
+        REQUIRE(cut.vertex[1] == Vector3(0, 0.5, 0));
+        REQUIRE(cut.has_uvs);
+        REQUIRE(cut.uv[1] == Vector2(0.5, 0));
+        REQUIRE(cut.source_index[1] == -1);
+    }
+
     SECTION("set_uvs") {
         SlicerFace face;
         face.set_uvs(Vector2(0, 0), Vector2(0.5, 0.5), Vector2(1, 1));
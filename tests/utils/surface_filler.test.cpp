@@ -12,7 +12,7 @@ TEST_CASE( "[surface_filler]") {
         face_1.set_tangents(SlicerVector4(1, 0, 0, 1), SlicerVector4(1, 0, 0, 1), SlicerVector4(1, 0, 0, 1));
         face_2.set_tangents(SlicerVector4(1, 0, 0, 1), SlicerVector4(1, 0, 0, 1), SlicerVector4(1, 0, 0, 1));
 
-        PoolVector<SlicerFace> faces;
+        Vector<SlicerFace> faces;
         faces.push_back(face_1);
         faces.push_back(face_2);
 
@@ -72,5 +72,24 @@ TEST_CASE( "[surface_filler]") {
             REQUIRE(tangents[i + 2] == 0);
             REQUIRE(tangents[i + 3] == 1);
         }
+
+        REQUIRE(mesh.surface_get_format(0) & Mesh::ARRAY_COMPRESS_TEX_UV);
+        REQUIRE(mesh.get_aabb() == AABB(Vector3(0, 0, 0), Vector3(1, 0, 1)));
+    }
+
+    SECTION("uses the same vertex layout as the visual server") {
+        uint32_t offsets[Mesh::ARRAY_MAX];
+        uint32_t format = Mesh::ARRAY_FORMAT_VERTEX | Mesh::ARRAY_FORMAT_NORMAL | Mesh::ARRAY_FORMAT_TEX_UV | Mesh::ARRAY_FORMAT_COLOR;
+
+        REQUIRE(SurfaceFiller::make_offsets_from_format(format, offsets) == 12 + 12 + 16 + 8);
+        REQUIRE(offsets[Mesh::ARRAY_VERTEX] == 0);
+        REQUIRE(offsets[Mesh::ARRAY_NORMAL] == 12);
+        REQUIRE(offsets[Mesh::ARRAY_COLOR] == 24);
+        REQUIRE(offsets[Mesh::ARRAY_TEX_UV] == 40);
+
+        REQUIRE(SurfaceFiller::make_offsets_from_format(format | Mesh::ARRAY_COMPRESS_DEFAULT, offsets) == 12 + 4 + 4 + 4);
+        REQUIRE(offsets[Mesh::ARRAY_NORMAL] == 12);
+        REQUIRE(offsets[Mesh::ARRAY_COLOR] == 16);
+        REQUIRE(offsets[Mesh::ARRAY_TEX_UV] == 20);
     }
 }
@@ -0,0 +1,98 @@
+#include "../catch.hpp"
+#include "../../utils/task_graph.h"
+#include "core/safe_refcount.h"
+
+struct OrderingJob {
+    volatile uint32_t next_slot;
+    // Which slot each task finished in
+    int finished_at[16];
+    int run_count[16];
+};
+
+void ordering_task(void *userdata, int idx) {
+    OrderingJob *job = (OrderingJob *)userdata;
+    job->run_count[idx]++;
+    job->finished_at[idx] = atomic_increment(&job->next_slot);
+}
+
+/**
+ * A diamond, roughly: 0 feeds 1 through 6, which all feed 7, and then
+ * everything from 8 onwards hangs off 7 in a chain
+*/
+void build_ordering_graph(TaskGraph &graph, OrderingJob *job) {
+    for (int i = 0; i < 16; i++) {
+        graph.add_task(ordering_task, job, i);
+    }
+
+    for (int i = 1; i < 7; i++) {
+        graph.add_dependency(i, 0);
+        graph.add_dependency(7, i);
+    }
+
+    for (int i = 8; i < 16; i++) {
+        graph.add_dependency(i, i - 1);
+    }
+}
+
+bool runs_in_order(const OrderingJob &job) {
+    for (int i = 0; i < 16; i++) {
+        if (job.run_count[i] != 1) {
+            return false;
+        }
+    }
+
+    for (int i = 1; i < 7; i++) {
+        if (job.finished_at[i] <= job.finished_at[0] || job.finished_at[7] <= job.finished_at[i]) {
+            return false;
+        }
+    }
+
+    for (int i = 8; i < 16; i++) {
+        if (job.finished_at[i] <= job.finished_at[i - 1]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+TEST_CASE( "[TaskGraph]" ) {
+    OrderingJob job;
+    job.next_slot = 0;
+    for (int i = 0; i < 16; i++) {
+        job.finished_at[i] = 0;
+        job.run_count[i] = 0;
+    }
+
+    TaskGraph graph;
+    build_ordering_graph(graph, &job);
+    REQUIRE( graph.get_task_count() == 16 );
+
+    SECTION( "Runs on the calling thread without a pool" ) {
+        graph.run();
+        REQUIRE( runs_in_order(job) );
+
+        // Nothing holds the first few back from going in the order they were added
+        REQUIRE( job.finished_at[0] == 1 );
+        REQUIRE( job.finished_at[1] == 2 );
+    }
+
+    SECTION( "Runs on the pool's workers" ) {
+        WorkerPool pool(3);
+        WorkerPool::set_singleton(&pool);
+        graph.run();
+        WorkerPool::set_singleton(NULL);
+
+        REQUIRE( runs_in_order(job) );
+        REQUIRE( pool.get_stats().tasks == 16 );
+    }
+
+    SECTION( "Runs on a pool without any workers" ) {
+        WorkerPool pool(0);
+        WorkerPool::set_singleton(&pool);
+        graph.run();
+        WorkerPool::set_singleton(NULL);
+
+        REQUIRE( runs_in_order(job) );
+    }
+}
@@ -3,14 +3,14 @@
 
 TEST_CASE( "[triangulator]" ) {
     SECTION("monotone_chain") {
-        PoolVector<Vector3> interception_points;
+        Vector<Vector3> interception_points;
         interception_points.push_back(Vector3(0, 0, 0));
         interception_points.push_back(Vector3(1, 0, 0));
         interception_points.push_back(Vector3(1, 0, 1));
         interception_points.push_back(Vector3(0, 0, 1));
         interception_points.push_back(Vector3(0.5, 0, 0.5));
 
-        PoolVector<SlicerFace> faces = Triangulator::monotone_chain(interception_points, Vector3(0, 1, 0));
+        Vector<SlicerFace> faces = Triangulator::monotone_chain(interception_points, Vector3(0, 1, 0));
         REQUIRE(faces.size() == 2);
         REQUIRE(faces[0] == SlicerFace(Vector3(1, 0, 1), Vector3(0, 0, 1), Vector3(0, 0, 0)));
         REQUIRE(faces[1] == SlicerFace(Vector3(1, 0, 1), Vector3(0, 0, 0), Vector3(1, 0, 0)));
@@ -31,5 +31,22 @@ TEST_CASE( "[triangulator]" ) {
         REQUIRE(faces[1].tangent[0] == SlicerVector4(-1, 0, 0, -1));
         REQUIRE(faces[1].tangent[1] == SlicerVector4(-1, 0, 0, -1));
         REQUIRE(faces[1].tangent[2] == SlicerVector4(-1, 0, 0, -1));
+
+        SECTION("maps axis aligned planes the same as any other") {
+            // Tilting the normal the tiniest amount keeps it off of the axis aligned path
+            // without changing how the points get mapped
+            Vector<SlicerFace> general = Triangulator::monotone_chain(interception_points, Vector3(0, 1, 0.0000001).normalized());
+            REQUIRE(general.size() == faces.size());
+            for (int i = 0; i < faces.size(); i++) {
+                REQUIRE(general[i] == faces[i]);
+            }
+        }
+
+        SECTION("maps uvs into a region of the texture") {
+            Vector<SlicerFace> atlased = Triangulator::monotone_chain(interception_points, Vector3(0, 1, 0), Rect2(0.5, 0, 0.5, 0.25));
+            REQUIRE(atlased.size() == 2);
+            REQUIRE((atlased[0].uv[0] == Vector2(0.5, 0) && atlased[0].uv[1] == Vector2(1, 0) && atlased[0].uv[2] == Vector2(1, 0.25)));
+            REQUIRE((atlased[1].uv[0] == Vector2(0.5, 0) && atlased[1].uv[1] == Vector2(1, 0.25) && atlased[1].uv[2] == Vector2(0.5, 0.25)));
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "../catch.hpp"
+#include "../../utils/worker_pool.h"
+#include "core/safe_refcount.h"
+
+struct CountingJob {
+    WorkerPool *pool;
+    volatile uint32_t counts[1000];
+};
+
+void count_task(void *userdata, int idx) {
+    CountingJob *job = (CountingJob *)userdata;
+    atomic_increment(&job->counts[idx]);
+}
+
+// Each index hands over ten more, to see that work can be handed over from inside work
+void nested_task(void *userdata, int idx) {
+    CountingJob *job = (CountingJob *)userdata;
+    job->pool->for_each(10, count_task, job);
+    atomic_increment(&job->counts[100 + idx]);
+}
+
+bool every_count_is(const CountingJob &job, int count, uint32_t expected) {
+    for (int i = 0; i < count; i++) {
+        if (job.counts[i] != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE( "[WorkerPool]" ) {
+    CountingJob *job = memnew(CountingJob);
+    for (int i = 0; i < 1000; i++) {
+        job->counts[i] = 0;
+    }
+
+    SECTION( "Runs every index exactly once" ) {
+        WorkerPool pool(3);
+        job->pool = &pool;
+        pool.for_each(1000, count_task, job);
+        REQUIRE( every_count_is(*job, 1000, 1) );
+
+        WorkerPool::Stats stats = pool.get_stats();
+        REQUIRE( stats.thread_count == 3 );
+        REQUIRE( stats.batches == 1 );
+        REQUIRE( stats.tasks == 1000 );
+
+        pool.reset_stats();
+        REQUIRE( pool.get_stats().tasks == 0 );
+    }
+
+    SECTION( "Runs everything on the calling thread without any workers" ) {
+        WorkerPool pool(0);
+        job->pool = &pool;
+        pool.for_each(1000, count_task, job);
+        REQUIRE( every_count_is(*job, 1000, 1) );
+        REQUIRE( pool.get_stats().steals == 0 );
+    }
+
+    SECTION( "Lets tasks hand over more work" ) {
+        WorkerPool pool(3);
+        job->pool = &pool;
+        pool.for_each(20, nested_task, job);
+
+        // Every one of the 20 tasks counted the first ten indexes once more
+        REQUIRE( every_count_is(*job, 10, 20) );
+        for (int i = 0; i < 20; i++) {
+            REQUIRE( job->counts[100 + i] == 1 );
+        }
+        REQUIRE( pool.get_stats().batches == 21 );
+    }
+
+    memdelete(job);
+}
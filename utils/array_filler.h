@@ -0,0 +1,189 @@
+#ifndef ARRAY_FILLER_H
+#define ARRAY_FILLER_H
+
+#include "slicer_face.h"
+
+/**
+ * Like SurfaceFiller, this takes SlicerFaces and turns them back into vertex data,
+ * but into a set of arrays laid out like Mesh::ARRAY_* instead of a packed vertex
+ * buffer. Nothing here touches the VisualServer, which makes it handy for anyone
+ * holding on to their geometry as arrays rather than meshes
+*/
+struct ArrayFiller {
+    bool has_normals;
+    bool has_tangents;
+    bool has_colors;
+    bool has_bones;
+    bool has_weights;
+    bool has_uvs;
+    bool has_uv2s;
+
+    Vector<SlicerFace> faces;
+    const SlicerFace *faces_reader;
+
+    PoolVector<Vector3> vertices;
+    PoolVector<Vector3>::Write vertices_writer;
+
+    PoolVector<Vector3> normals;
+    PoolVector<Vector3>::Write normals_writer;
+
+    PoolVector<real_t> tangents;
+    PoolVector<real_t>::Write tangents_writer;
+
+    PoolVector<Color> colors;
+    PoolVector<Color>::Write colors_writer;
+
+    PoolVector<int> bones;
+    PoolVector<int>::Write bones_writer;
+
+    PoolVector<real_t> weights;
+    PoolVector<real_t>::Write weights_writer;
+
+    PoolVector<Vector2> uvs;
+    PoolVector<Vector2>::Write uvs_writer;
+
+    PoolVector<Vector2> uv2s;
+    PoolVector<Vector2>::Write uv2s_writer;
+
+    ArrayFiller(const Vector<SlicerFace> &p_faces) {
+        faces = p_faces;
+        faces_reader = faces.ptr();
+        const SlicerFace &first_face = faces_reader[0];
+
+        has_normals = first_face.has_normals;
+        has_tangents = first_face.has_tangents;
+        has_colors = first_face.has_colors;
+        has_bones = first_face.has_bones;
+        has_weights = first_face.has_weights;
+        has_uvs = first_face.has_uvs;
+        has_uv2s = first_face.has_uv2s;
+
+        int vertex_count = faces.size() * 3;
+
+        vertices.resize(vertex_count);
+        vertices_writer = vertices.write();
+
+        if (has_normals) {
+            normals.resize(vertex_count);
+            normals_writer = normals.write();
+        }
+
+        if (has_tangents) {
+            tangents.resize(vertex_count * 4);
+            tangents_writer = tangents.write();
+        }
+
+        if (has_colors) {
+            colors.resize(vertex_count);
+            colors_writer = colors.write();
+        }
+
+        if (has_bones) {
+            bones.resize(vertex_count * 4);
+            bones_writer = bones.write();
+        }
+
+        if (has_weights) {
+            weights.resize(vertex_count * 4);
+            weights_writer = weights.write();
+        }
+
+        if (has_uvs) {
+            uvs.resize(vertex_count);
+            uvs_writer = uvs.write();
+        }
+
+        if (has_uv2s) {
+            uv2s.resize(vertex_count);
+            uv2s_writer = uv2s.write();
+        }
+    }
+
+    /**
+     * Takes data from the faces using the lookup_idx and writes it into
+     * the arrays at set_idx, the same way SurfaceFiller::fill does
+    */
+    _FORCE_INLINE_ void fill(int lookup_idx, int set_idx) {
+        const SlicerFace &face = faces_reader[lookup_idx / 3];
+        int idx_offset = lookup_idx % 3;
+
+        vertices_writer[set_idx] = face.vertex[idx_offset];
+
+        if (has_normals) {
+            normals_writer[set_idx] = face.normal[idx_offset];
+        }
+
+        if (has_tangents) {
+            for (int i = 0; i < 4; i++) {
+                tangents_writer[set_idx * 4 + i] = face.tangent[idx_offset][i];
+            }
+        }
+
+        if (has_colors) {
+            colors_writer[set_idx] = face.color[idx_offset];
+        }
+
+        if (has_bones) {
+            for (int i = 0; i < 4; i++) {
+                bones_writer[set_idx * 4 + i] = (int)face.bones[idx_offset][i];
+            }
+        }
+
+        if (has_weights) {
+            for (int i = 0; i < 4; i++) {
+                weights_writer[set_idx * 4 + i] = face.weights[idx_offset][i];
+            }
+        }
+
+        if (has_uvs) {
+            uvs_writer[set_idx] = face.uv[idx_offset];
+        }
+
+        if (has_uv2s) {
+            uv2s_writer[set_idx] = face.uv2[idx_offset];
+        }
+    }
+
+    /**
+     * Finishes writing and hands back the arrays. Anything the faces didn't have is left null
+    */
+    Array get_arrays() {
+        vertices_writer.release();
+        normals_writer.release();
+        tangents_writer.release();
+        colors_writer.release();
+        bones_writer.release();
+        weights_writer.release();
+        uvs_writer.release();
+        uv2s_writer.release();
+
+        Array arrays;
+        arrays.resize(Mesh::ARRAY_MAX);
+        arrays[Mesh::ARRAY_VERTEX] = vertices;
+
+        if (has_normals)
+            arrays[Mesh::ARRAY_NORMAL] = normals;
+
+        if (has_tangents)
+            arrays[Mesh::ARRAY_TANGENT] = tangents;
+
+        if (has_colors)
+            arrays[Mesh::ARRAY_COLOR] = colors;
+
+        if (has_bones)
+            arrays[Mesh::ARRAY_BONES] = bones;
+
+        if (has_weights)
+            arrays[Mesh::ARRAY_WEIGHTS] = weights;
+
+        if (has_uvs)
+            arrays[Mesh::ARRAY_TEX_UV] = uvs;
+
+        if (has_uv2s)
+            arrays[Mesh::ARRAY_TEX_UV2] = uv2s;
+
+        return arrays;
+    }
+};
+
+#endif // ARRAY_FILLER_H
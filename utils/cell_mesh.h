@@ -0,0 +1,91 @@
+#ifndef CELL_MESH_H
+#define CELL_MESH_H
+
+#include "surface_filler.h"
+#include "mesh_pool.h"
+
+/**
+ * A surface of the mesh being cut up, along with everything we need to
+ * know to turn its pieces back into surfaces
+*/
+struct SourceSurface {
+    Vector<SlicerFace> faces;
+    Ref<Material> material;
+    uint32_t compression;
+
+    SourceSurface() {
+        compression = Mesh::ARRAY_COMPRESS_DEFAULT;
+    }
+};
+
+/**
+ * Gathers up the faces that end up in one piece (or "cell") of a mesh that's being cut into
+ * more than two parts, such as by dicing or shattering it, and turns them into a mesh once
+ * everything has been cut
+*/
+struct CellMesh {
+    // Faces for each of the source surfaces, in the same order
+    Vector<Vector<SlicerFace> > surface_faces;
+    Vector<SlicerFace> cross_section_faces;
+
+    CellMesh() {}
+
+    CellMesh(int surface_count) {
+        surface_faces.resize(surface_count);
+    }
+
+    bool is_empty() const {
+        if (cross_section_faces.size() > 0) {
+            return false;
+        }
+
+        for (int i = 0; i < surface_faces.size(); i++) {
+            if (surface_faces[i].size() > 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Creates a mesh with a surface for each source surface that has faces in this cell, plus
+     * one for the cross section. Like SlicedMesh, a null cross section material falls back
+     * on whatever the first surface is using. The mesh comes out of the pool if one is given
+    */
+    Ref<ArrayMesh> create_mesh(const Vector<SourceSurface> &sources, Ref<Material> cross_section_material, uint32_t cross_section_compression, MeshPool *pool = NULL) const {
+        Ref<ArrayMesh> mesh;
+        if (pool) {
+            mesh = pool->take_mesh();
+        } else {
+            mesh.instance();
+        }
+
+        for (int i = 0; i < surface_faces.size(); i++) {
+            add_surface(**mesh, surface_faces[i], sources[i].material, sources[i].compression);
+        }
+
+        if (cross_section_material.is_null() && mesh->get_surface_count() > 0) {
+            cross_section_material = mesh->surface_get_material(0);
+        }
+
+        add_surface(**mesh, cross_section_faces, cross_section_material, cross_section_compression);
+        return mesh;
+    }
+
+private:
+    static void add_surface(ArrayMesh &mesh, const Vector<SlicerFace> &faces, Ref<Material> material, uint32_t compression) {
+        if (faces.size() == 0) {
+            return;
+        }
+
+        SurfaceFiller filler(faces, compression);
+        for (int i = 0; i < faces.size() * 3; i++) {
+            filler.fill(i, i);
+        }
+
+        filler.add_to_mesh(mesh, material);
+    }
+};
+
+#endif // CELL_MESH_H
@@ -0,0 +1,251 @@
+#ifndef CLIP_POLYGON_H
+#define CLIP_POLYGON_H
+
+#include "slicer_face.h"
+
+/**
+ * A single vertex of a ClipPolygon, holding the same per vertex data that a
+ * corner of a SlicerFace does
+*/
+struct ClipVertex {
+    Vector3 vertex;
+    Vector3 normal;
+    SlicerVector4 tangent;
+    Color color;
+    SlicerVector4 bones;
+    SlicerVector4 weights;
+    Vector2 uv;
+    Vector2 uv2;
+    int source_index;
+
+    static ClipVertex from_face(const SlicerFace &face, int idx) {
+        ClipVertex result;
+        result.vertex = face.vertex[idx];
+        result.normal = face.normal[idx];
+        result.tangent = face.tangent[idx];
+        result.color = face.color[idx];
+        result.bones = face.bones[idx];
+        result.weights = face.weights[idx];
+        result.uv = face.uv[idx];
+        result.uv2 = face.uv2[idx];
+        result.source_index = face.source_index[idx];
+        return result;
+    }
+
+    /**
+     * Interpolates all of the data of two vertexes. Like SlicerFace::set_vertex_between,
+     * the new vertex doesn't exist in the source surface and so has no source_index
+    */
+    static ClipVertex between(const ClipVertex &a, const ClipVertex &b, real_t t) {
+        ClipVertex result;
+        result.vertex = a.vertex + t * (b.vertex - a.vertex);
+        result.normal = a.normal * (1 - t) + b.normal * t;
+        result.tangent = a.tangent * (1 - t) + b.tangent * t;
+        result.color = a.color * (1 - t) + b.color * t;
+        result.bones = a.bones * (1 - t) + b.bones * t;
+        result.weights = a.weights * (1 - t) + b.weights * t;
+        result.uv = a.uv * (1 - t) + b.uv * t;
+        result.uv2 = a.uv2 * (1 - t) + b.uv2 * t;
+        result.source_index = -1;
+        return result;
+    }
+
+    void to_face(SlicerFace &face, int idx) const {
+        face.vertex[idx] = vertex;
+        face.normal[idx] = normal;
+        face.tangent[idx] = tangent;
+        face.color[idx] = color;
+        face.bones[idx] = bones;
+        face.weights[idx] = weights;
+        face.uv[idx] = uv;
+        face.uv2[idx] = uv2;
+        face.source_index[idx] = source_index;
+    }
+};
+
+/**
+ * A convex polygon that started out as a SlicerFace and is being cut down by a series of
+ * planes, Sutherland–Hodgman style. Where Intersector deals with a single plane at a time
+ * and hands back triangles, this lets a face be cut by any number of planes before it's
+ * turned back into triangles, without going through any intermediate meshes
+*/
+struct ClipPolygon {
+    // A triangle gains at most one vertex per plane it's clipped against, so this many
+    // vertexes are kept in the polygon itself, which covers a triangle cut by up to 29
+    // planes. Past that (like a cell of a shatter with lots of seeds) they carry on in
+    // extra_vertexes, so there's no limit on how many planes a polygon can be clipped by
+    static const int MAX_INLINE_VERTEXES = 32;
+
+    int count;
+
+    // Which of the vertex data is actually in use, as taken from the original face
+    bool has_normals;
+    bool has_tangents;
+    bool has_colors;
+    bool has_bones;
+    bool has_weights;
+    bool has_uvs;
+    bool has_uv2s;
+
+    static ClipPolygon from_face(const SlicerFace &face) {
+        ClipPolygon result;
+        for (int i = 0; i < 3; i++) {
+            result.add(ClipVertex::from_face(face, i));
+        }
+
+        result.has_normals = face.has_normals;
+        result.has_tangents = face.has_tangents;
+        result.has_colors = face.has_colors;
+        result.has_bones = face.has_bones;
+        result.has_weights = face.has_weights;
+        result.has_uvs = face.has_uvs;
+        result.has_uv2s = face.has_uv2s;
+        return result;
+    }
+
+    /**
+     * Splits the polygon into the parts above and below the plane. Either side is left empty
+     * if none of the polygon actually falls on it (a polygon that only touches the plane doesn't
+     * count). Any points that lie on the plane get added to intersection_points, if given, so that
+     * they can be used to build a cross section
+    */
+    void split(const Plane &plane, ClipPolygon &r_upper, ClipPolygon &r_lower, Vector<Vector3> *intersection_points = NULL) const {
+        r_upper.copy_format(*this);
+        r_lower.copy_format(*this);
+
+        bool upper_used = false;
+        bool lower_used = false;
+
+        // Each distance is carried over to the next edge rather than being worked out twice
+        real_t first_dist = count > 0 ? plane.distance_to(get_vertex(0).vertex) : 0;
+        real_t next_dist = first_dist;
+
+        for (int i = 0; i < count; i++) {
+            int next = (i + 1) % count;
+            const ClipVertex &current = get_vertex(i);
+            real_t dist = next_dist;
+            next_dist = next == 0 ? first_dist : plane.distance_to(get_vertex(next).vertex);
+
+            if (dist > CMP_EPSILON) {
+                r_upper.add(current);
+                upper_used = true;
+            } else if (dist < -CMP_EPSILON) {
+                r_lower.add(current);
+                lower_used = true;
+            } else {
+                r_upper.add(current);
+                r_lower.add(current);
+                if (intersection_points) {
+                    intersection_points->push_back(current.vertex);
+                }
+            }
+
+            // Same formula as Intersector, so shared edges get cut at the same points
+            if ((dist > CMP_EPSILON && next_dist < -CMP_EPSILON) || (dist < -CMP_EPSILON && next_dist > CMP_EPSILON)) {
+                Vector3 a = current.vertex;
+                Vector3 ab = get_vertex(next).vertex - a;
+                real_t t = (plane.d - plane.normal.dot(a)) / (plane.normal.dot(ab));
+
+                ClipVertex intersection = ClipVertex::between(current, get_vertex(next), t);
+                r_upper.add(intersection);
+                r_lower.add(intersection);
+                if (intersection_points) {
+                    intersection_points->push_back(intersection.vertex);
+                }
+            }
+        }
+
+        if (!upper_used) {
+            r_upper.count = 0;
+            r_upper.extra_vertexes.clear();
+        }
+
+        if (!lower_used) {
+            r_lower.count = 0;
+            r_lower.extra_vertexes.clear();
+        }
+    }
+
+    /**
+     * Cuts away everything above the plane
+    */
+    void clip(const Plane &plane, ClipPolygon &r_inside, Vector<Vector3> *intersection_points = NULL) const {
+        ClipPolygon outside;
+        split(plane, outside, r_inside, intersection_points);
+    }
+
+    bool is_empty() const {
+        return count < 3;
+    }
+
+    _FORCE_INLINE_ const ClipVertex &get_vertex(int idx) const {
+        return idx < MAX_INLINE_VERTEXES ? inline_vertexes[idx] : extra_vertexes[idx - MAX_INLINE_VERTEXES];
+    }
+
+    /**
+     * Fans the polygon back out into triangles. As the polygon is convex, every triangle
+     * keeps the winding of the face it came from (or the opposite winding, if reversed)
+    */
+    void triangulate(Vector<SlicerFace> &faces, bool reversed = false) const {
+        if (is_empty()) {
+            return;
+        }
+
+        int size = faces.size();
+        faces.resize(size + count - 2);
+        SlicerFace *faces_writer = faces.ptrw();
+
+        for (int i = 1; i < count - 1; i++) {
+            SlicerFace &face = faces_writer[size + i - 1];
+            face.has_normals = has_normals;
+            face.has_tangents = has_tangents;
+            face.has_colors = has_colors;
+            face.has_bones = has_bones;
+            face.has_weights = has_weights;
+            face.has_uvs = has_uvs;
+            face.has_uv2s = has_uv2s;
+
+            get_vertex(0).to_face(face, 0);
+            get_vertex(i).to_face(face, reversed ? 2 : 1);
+            get_vertex(i + 1).to_face(face, reversed ? 1 : 2);
+        }
+    }
+
+    ClipPolygon() {
+        count = 0;
+        has_normals = false;
+        has_tangents = false;
+        has_colors = false;
+        has_bones = false;
+        has_weights = false;
+        has_uvs = false;
+        has_uv2s = false;
+    }
+
+private:
+    ClipVertex inline_vertexes[MAX_INLINE_VERTEXES];
+    Vector<ClipVertex> extra_vertexes;
+
+    _FORCE_INLINE_ void add(const ClipVertex &vertex) {
+        if (count < MAX_INLINE_VERTEXES) {
+            inline_vertexes[count] = vertex;
+        } else {
+            extra_vertexes.push_back(vertex);
+        }
+        count++;
+    }
+
+    void copy_format(const ClipPolygon &other) {
+        count = 0;
+        extra_vertexes.clear();
+        has_normals = other.has_normals;
+        has_tangents = other.has_tangents;
+        has_colors = other.has_colors;
+        has_bones = other.has_bones;
+        has_weights = other.has_weights;
+        has_uvs = other.has_uvs;
+        has_uv2s = other.has_uv2s;
+    }
+};
+
+#endif // CLIP_POLYGON_H
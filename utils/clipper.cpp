@@ -0,0 +1,159 @@
+#include "clipper.h"
+#include "triangulator.h"
+
+namespace Clipper {
+    enum Containment {
+        INSIDE,
+        OUTSIDE,
+        CROSSING
+    };
+
+    /**
+     * Whether two planes are (near enough) the same. Clipping a cross section by its own plane
+     * would leave nothing behind as every point of it lies right on the plane
+    */
+    bool is_same_plane(const Plane &a, const Plane &b) {
+        return a.normal.dot(b.normal) > 1 - CMP_EPSILON && ABS(a.d - b.d) <= CMP_EPSILON;
+    }
+
+    /**
+     * Adds the points where a face meets a plane, using the same formula as
+     * Intersector so that shared edges are cut at the same points
+    */
+    void add_plane_points(const SlicerFace &face, const Plane &plane, const real_t *dists, Vector<Vector3> &points) {
+        for (int i = 0; i < 3; i++) {
+            int next = (i + 1) % 3;
+
+            if (ABS(dists[i]) <= CMP_EPSILON) {
+                points.push_back(face.vertex[i]);
+            } else if ((dists[i] > CMP_EPSILON && dists[next] < -CMP_EPSILON) || (dists[i] < -CMP_EPSILON && dists[next] > CMP_EPSILON)) {
+                Vector3 ab = face.vertex[next] - face.vertex[i];
+                real_t t = (plane.d - plane.normal.dot(face.vertex[i])) / plane.normal.dot(ab);
+                points.push_back(face.vertex[i] + t * ab);
+            }
+        }
+    }
+
+    /**
+     * Works out whether a face can be passed along whole, while gathering up where it meets
+     * each plane. Touching a plane doesn't count as crossing it, the same way it doesn't when
+     * a ClipPolygon is split
+    */
+    Containment get_containment(const SlicerFace &face, const Vector<Plane> &planes, Vector<Vector<Vector3> > &plane_points) {
+        Containment containment = INSIDE;
+
+        for (int i = 0; i < planes.size(); i++) {
+            real_t dists[3];
+            bool over = false;
+            bool under = false;
+            bool on = false;
+            for (int j = 0; j < 3; j++) {
+                dists[j] = planes[i].distance_to(face.vertex[j]);
+                over = over || dists[j] > CMP_EPSILON;
+                under = under || dists[j] < -CMP_EPSILON;
+                on = on || ABS(dists[j]) <= CMP_EPSILON;
+            }
+
+            if ((over && under) || on) {
+                add_plane_points(face, planes[i], dists, plane_points.ptrw()[i]);
+            }
+
+            if (over && !under) {
+                containment = OUTSIDE;
+            } else if (over && containment != OUTSIDE) {
+                containment = CROSSING;
+            }
+        }
+
+        return containment;
+    }
+
+    void clip_to_convex(const Vector<SourceSurface> &sources, const Vector<Plane> &planes, bool keep_outside, CellMesh &r_inside, CellMesh &r_outside, Rect2 uv_rect) {
+        r_inside = CellMesh(sources.size());
+        r_outside = CellMesh(sources.size());
+
+        // The points where the mesh meets each plane. These need to come from the faces
+        // before they've been clipped, as the corners of the volume's cross sections can
+        // lie on planes that were never reached by a face
+        Vector<Vector<Vector3> > plane_points;
+        plane_points.resize(planes.size());
+
+        for (int i = 0; i < sources.size(); i++) {
+            Vector<SlicerFace> &inside_faces = r_inside.surface_faces.ptrw()[i];
+            Vector<SlicerFace> &outside_faces = r_outside.surface_faces.ptrw()[i];
+            const SlicerFace *faces_reader = sources[i].faces.ptr();
+
+            for (int j = 0; j < sources[i].faces.size(); j++) {
+                const SlicerFace &face = faces_reader[j];
+
+                Containment containment = get_containment(face, planes, plane_points);
+                if (containment == INSIDE) {
+                    inside_faces.push_back(face);
+                    continue;
+                } else if (containment == OUTSIDE) {
+                    if (keep_outside) {
+                        outside_faces.push_back(face);
+                    }
+                    continue;
+                }
+
+                // Whatever ends up above a plane is outside of the volume and is done with,
+                // while the rest carries on to be clipped by the next plane
+                ClipPolygon remaining = ClipPolygon::from_face(face);
+                for (int k = 0; k < planes.size() && !remaining.is_empty(); k++) {
+                    ClipPolygon upper;
+                    ClipPolygon lower;
+                    remaining.split(planes[k], upper, lower);
+
+                    if (keep_outside) {
+                        upper.triangulate(outside_faces);
+                    }
+
+                    remaining = lower;
+                }
+
+                remaining.triangulate(inside_faces);
+            }
+        }
+
+        for (int i = 0; i < planes.size(); i++) {
+            if (plane_points[i].size() < 3) {
+                continue;
+            }
+
+            // A plane that's been passed in more than once only gets one cross section
+            bool is_duplicate = false;
+            for (int j = 0; j < i && !is_duplicate; j++) {
+                is_duplicate = is_same_plane(planes[i], planes[j]);
+            }
+
+            if (is_duplicate) {
+                continue;
+            }
+
+            // Trim the mesh's cross section down to the part of it that's inside the volume
+            Vector<SlicerFace> cross_section = Triangulator::monotone_chain(plane_points[i], planes[i].normal, uv_rect);
+            const SlicerFace *cross_section_reader = cross_section.ptr();
+
+            for (int j = 0; j < cross_section.size(); j++) {
+                ClipPolygon polygon = ClipPolygon::from_face(cross_section_reader[j]);
+                for (int k = 0; k < planes.size() && !polygon.is_empty(); k++) {
+                    if (is_same_plane(planes[i], planes[k])) {
+                        continue;
+                    }
+
+                    ClipPolygon inside;
+                    polygon.clip(planes[k], inside);
+                    polygon = inside;
+                }
+
+                // The inside is below the plane and the outside above it, just like
+                // the lower and upper halves of a regular slice
+                polygon.triangulate(r_inside.cross_section_faces);
+                if (keep_outside) {
+                    polygon.triangulate(r_outside.cross_section_faces, true);
+                }
+            }
+        }
+    }
+} // Clipper
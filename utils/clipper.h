@@ -0,0 +1,22 @@
+#ifndef CLIPPER_H
+#define CLIPPER_H
+
+#include "cell_mesh.h"
+#include "clip_polygon.h"
+
+/**
+ * Contains functions for cutting a mesh down to the part of it that sits
+ * inside of a convex volume
+*/
+namespace Clipper {
+    /**
+     * Clips every source surface against all of the planes at once, keeping what's below every
+     * one of them (so plane normals should face out of the volume). Each face is run through the
+     * planes one after another, without any intermediate meshes being built, and each plane that
+     * actually cuts the mesh gets a cross section on both sides of it. r_outside is only filled
+     * in if keep_outside is set
+    */
+    void clip_to_convex(const Vector<SourceSurface> &sources, const Vector<Plane> &planes, bool keep_outside, CellMesh &r_inside, CellMesh &r_outside, Rect2 uv_rect = Rect2(0, 0, 1, 1));
+} // Clipper
+
+#endif // CLIPPER_H
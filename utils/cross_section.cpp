@@ -0,0 +1,203 @@
+#include "cross_section.h"
+#include <algorithm>
+
+// How close the ends of two lines need to be for them to be joined up. Meshes tend to
+// duplicate vertexes along their UV seams and the copies don't always land on exactly
+// the same spot
+static const real_t WELD_DISTANCE = 0.0001;
+
+/**
+ * A line along which the plane crosses a face. Lines are matched up by their keys, which
+ * are their ends snapped to a grid WELD_DISTANCE apart
+*/
+struct Segment {
+    Vector3 from;
+    Vector3 to;
+    Vector3 from_key;
+    Vector3 to_key;
+
+    struct Comparator {
+        _FORCE_INLINE_ bool operator()(const Segment &a, const Segment &b) const {
+            return a.from_key < b.from_key;
+        }
+
+        _FORCE_INLINE_ bool operator()(const Segment &a, const Vector3 &b) const {
+            return a.from_key < b;
+        }
+    };
+};
+
+/**
+ * Finds where the edge between a and b crosses the plane. Neighbouring faces share their
+ * edges but don't agree on which way they run, so the ends are put into a fixed order first.
+ * That way both faces come up with exactly the same point rather than two that are only
+ * nearly the same, and which could end up snapped to different keys
+*/
+Vector3 edge_point(const Plane &plane, Vector3 a, Vector3 b) {
+    if (b < a) {
+        SWAP(a, b);
+    }
+
+    Vector3 ab = b - a;
+    real_t t = (plane.d - plane.normal.dot(a)) / plane.normal.dot(ab);
+    return a + ab * t;
+}
+
+namespace CrossSection {
+    real_t Loop::area(const Vector3 &normal) const {
+        if (!is_closed || points.size() < 3) {
+            return 0;
+        }
+
+        const Vector3 *points_reader = points.ptr();
+        Vector3 origin = points_reader[0];
+        Vector3 sum;
+        for (int i = 1; i < points.size() - 1; i++) {
+            sum += (points_reader[i] - origin).cross(points_reader[i + 1] - origin);
+        }
+
+        return normal.dot(sum) / 2;
+    }
+
+    real_t Loop::length() const {
+        const Vector3 *points_reader = points.ptr();
+        real_t total = 0;
+        for (int i = 1; i < points.size(); i++) {
+            total += points_reader[i].distance_to(points_reader[i - 1]);
+        }
+
+        if (is_closed && points.size() > 1) {
+            total += points_reader[0].distance_to(points_reader[points.size() - 1]);
+        }
+
+        return total;
+    }
+
+    bool cross_face(const Plane &plane, const Face3 &face, Vector3 &r_from, Vector3 &r_to) {
+        int sides[3];
+        for (int i = 0; i < 3; i++) {
+            real_t dist = plane.distance_to(face.vertex[i]);
+            sides[i] = dist > CMP_EPSILON ? 1 : (dist < -CMP_EPSILON ? -1 : 0);
+        }
+
+        Vector3 points[3];
+        int point_count = 0;
+        int on_count = 0;
+        int off_side = 0;
+
+        for (int i = 0; i < 3; i++) {
+            if (sides[i] == 0) {
+                points[point_count++] = face.vertex[i];
+                on_count++;
+            } else {
+                off_side = sides[i];
+            }
+        }
+
+        for (int i = 0; i < 3; i++) {
+            int j = (i + 1) % 3;
+            if (sides[i] * sides[j] < 0) {
+                points[point_count++] = edge_point(plane, face.vertex[i], face.vertex[j]);
+            }
+        }
+
+        // Either the plane only touches a corner or the face is lying flat on it
+        if (point_count != 2) {
+            return false;
+        }
+
+        // An edge lying on the plane is shared by a face on either side of it,
+        // so only the face above gets to count it
+        if (on_count == 2 && off_side < 0) {
+            return false;
+        }
+
+        r_from = points[0];
+        r_to = points[1];
+
+        // Faces are wound clockwise, same as Plane's default
+        Vector3 face_normal = (face.vertex[0] - face.vertex[2]).cross(face.vertex[0] - face.vertex[1]);
+        if ((r_to - r_from).dot(plane.normal.cross(face_normal)) < 0) {
+            SWAP(r_from, r_to);
+        }
+
+        return true;
+    }
+
+    Vector<Loop> find_loops(const PoolVector<Face3> &faces, const Plane &plane) {
+        Vector<Loop> loops;
+
+        Vector<Segment> segments;
+        PoolVector<Face3>::Read faces_reader = faces.read();
+        for (int i = 0; i < faces.size(); i++) {
+            Segment segment;
+            if (cross_face(plane, faces_reader[i], segment.from, segment.to)) {
+                segment.from_key = segment.from.snapped(Vector3(WELD_DISTANCE, WELD_DISTANCE, WELD_DISTANCE));
+                segment.to_key = segment.to.snapped(Vector3(WELD_DISTANCE, WELD_DISTANCE, WELD_DISTANCE));
+                segments.push_back(segment);
+            }
+        }
+
+        int count = segments.size();
+        if (count == 0) {
+            return loops;
+        }
+
+        // Sorting the lines by where they start lets us find the one that carries on from
+        // another with a binary search, and sorting where they end lets us find where the
+        // loops that aren't closed begin
+        segments.sort_custom<Segment::Comparator>();
+        const Segment *sorted = segments.ptr();
+
+        Vector<Vector3> ends;
+        ends.resize(count);
+        for (int i = 0; i < count; i++) {
+            ends.ptrw()[i] = sorted[i].to_key;
+        }
+        std::sort(ends.ptrw(), ends.ptrw() + count);
+
+        Vector<bool> used;
+        used.resize(count);
+        for (int i = 0; i < count; i++) {
+            used.ptrw()[i] = false;
+        }
+
+        // Open loops are walked first, from their start, so that they don't get broken
+        // up by a walk that happened to begin somewhere in their middle
+        for (int pass = 0; pass < 2; pass++) {
+            for (int i = 0; i < count; i++) {
+                if (used[i] || (pass == 0 && std::binary_search(ends.ptr(), ends.ptr() + count, sorted[i].from_key))) {
+                    continue;
+                }
+
+                Loop loop;
+                int current = i;
+                while (true) {
+                    used.ptrw()[current] = true;
+                    loop.points.push_back(sorted[current].from);
+
+                    const Vector3 &end = sorted[current].to_key;
+                    int next = std::lower_bound(sorted, sorted + count, end, Segment::Comparator()) - sorted;
+                    while (next < count && sorted[next].from_key == end && used[next]) {
+                        next++;
+                    }
+
+                    if (next == count || sorted[next].from_key != end) {
+                        if (end == sorted[i].from_key) {
+                            loop.is_closed = true;
+                        } else {
+                            loop.points.push_back(sorted[current].to);
+                        }
+                        break;
+                    }
+
+                    current = next;
+                }
+
+                loops.push_back(loop);
+            }
+        }
+
+        return loops;
+    }
+} // CrossSection
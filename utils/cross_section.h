@@ -0,0 +1,56 @@
+#ifndef CROSS_SECTION_H
+#define CROSS_SECTION_H
+
+#include "core/math/face3.h"
+#include "core/pool_vector.h"
+#include "core/vector.h"
+
+/**
+ * Contains functions for working out what the cross section of a cut would look like
+ * without actually cutting anything. Only the points where the plane crosses each
+ * face's edges are calculated, no faces are split and nothing is interpolated other
+ * than the positions
+*/
+namespace CrossSection {
+    /**
+     * An outline of where the plane passes through the mesh
+    */
+    struct Loop {
+        Vector<Vector3> points;
+
+        // Whether the last point joins back up with the first. Loops are left open when
+        // the mesh has holes in it or, sometimes, when the plane runs exactly along its edges
+        bool is_closed;
+
+        /**
+         * The area enclosed by the loop. Outlines run counterclockwise around the plane's
+         * normal (which needs to be a unit vector) and holes clockwise, so holes come out
+         * negative. Open loops have no area
+        */
+        real_t area(const Vector3 &normal) const;
+
+        /**
+         * The length of the outline, including the part joining the ends of a closed loop
+        */
+        real_t length() const;
+
+        Loop() {
+            is_closed = false;
+        }
+    };
+
+    /**
+     * If the plane passes through the face, sets r_from and r_to to the ends of the line the
+     * two of them meet along and returns true. The line runs counterclockwise around the plane's
+     * normal as seen from outside of the mesh, so that the loops it ends up in all wind the same way
+    */
+    bool cross_face(const Plane &plane, const Face3 &face, Vector3 &r_from, Vector3 &r_to);
+
+    /**
+     * Crosses every face with the plane and joins the lines that come out of it into loops.
+     * The plane should be normalized, as the faces are sorted onto each side of it by distance
+    */
+    Vector<Loop> find_loops(const PoolVector<Face3> &faces, const Plane &plane);
+} // CrossSection
+
+#endif // CROSS_SECTION_H
@@ -0,0 +1,291 @@
+#include "dicer.h"
+#include "triangulator.h"
+
+namespace Dicer {
+    /**
+     * Everything that's shared while a single mesh is being diced
+    */
+    struct DiceState {
+        const Vector<Axis> *axes;
+
+        // The range of slabs the mesh covers along each axis. Slab n lies
+        // between the boundaries at n * spacing and (n + 1) * spacing
+        int min_slab[3];
+        int slab_count[3];
+
+        // How far apart neighbouring cells along each axis are in cells
+        int stride[3];
+
+        Vector<CellMesh> cells;
+
+        // The points where the mesh crosses each of the interior boundaries of each
+        // axis. Boundary n is found at n - min_slab - 1
+        Vector<Vector<Vector3> > boundary_points[3];
+
+        int surface_idx;
+
+        int max_slab(int axis_idx) const {
+            return min_slab[axis_idx] + slab_count[axis_idx] - 1;
+        }
+
+        int cell_index(const int *coords) const {
+            int idx = 0;
+            for (int i = 0; i < axes->size(); i++) {
+                idx += (coords[i] - min_slab[i]) * stride[i];
+            }
+            return idx;
+        }
+    };
+
+    /**
+     * Finds the range of interior boundaries along an axis that something stretching from min_dist
+     * to max_dist touches. Returns false if it doesn't touch any, in which case it sits entirely
+     * within a single slab
+    */
+    bool get_boundaries(const DiceState &state, int axis_idx, real_t min_dist, real_t max_dist, int &r_first, int &r_last) {
+        real_t spacing = (*state.axes)[axis_idx].spacing;
+        r_first = MAX((int)Math::ceil((min_dist - CMP_EPSILON) / spacing), state.min_slab[axis_idx] + 1);
+        r_last = MIN((int)Math::floor((max_dist + CMP_EPSILON) / spacing), state.max_slab(axis_idx));
+        return r_first <= r_last;
+    }
+
+    /**
+     * The slab something that doesn't touch any boundaries falls in. Going by the middle
+     * avoids any ambiguity for things that only just touch one of the outer boundaries
+    */
+    int get_slab(const DiceState &state, int axis_idx, real_t min_dist, real_t max_dist) {
+        int slab = (int)Math::floor((min_dist + max_dist) * 0.5 / (*state.axes)[axis_idx].spacing);
+        return CLAMP(slab, state.min_slab[axis_idx], state.max_slab(axis_idx));
+    }
+
+    /**
+     * Cuts a polygon by every boundary of the axis it crosses, working from the lowest boundary
+     * up, and hands each piece on to the next axis. Once the polygon has made it through every
+     * axis it's fanned back out into its cell
+    */
+    void dice_polygon(DiceState &state, const ClipPolygon &polygon, int axis_idx, int *coords) {
+        if (axis_idx == state.axes->size()) {
+            CellMesh &cell = state.cells.ptrw()[state.cell_index(coords)];
+            polygon.triangulate(cell.surface_faces.ptrw()[state.surface_idx]);
+            return;
+        }
+
+        const Axis &axis = (*state.axes)[axis_idx];
+
+        real_t min_dist = axis.direction.dot(polygon.get_vertex(0).vertex);
+        real_t max_dist = min_dist;
+        for (int i = 1; i < polygon.count; i++) {
+            real_t dist = axis.direction.dot(polygon.get_vertex(i).vertex);
+            min_dist = MIN(min_dist, dist);
+            max_dist = MAX(max_dist, dist);
+        }
+
+        int first;
+        int last;
+        if (!get_boundaries(state, axis_idx, min_dist, max_dist, first, last)) {
+            coords[axis_idx] = get_slab(state, axis_idx, min_dist, max_dist);
+            dice_polygon(state, polygon, axis_idx + 1, coords);
+            return;
+        }
+
+        // Every cut leaves the piece below the boundary done with as far as this axis is
+        // concerned, while whatever's above carries on to be cut by the next boundary
+        ClipPolygon remaining = polygon;
+        for (int b = first; b <= last && !remaining.is_empty(); b++) {
+            ClipPolygon upper;
+            ClipPolygon lower;
+            Vector<Vector3> &points = state.boundary_points[axis_idx].ptrw()[b - state.min_slab[axis_idx] - 1];
+            remaining.split(Plane(axis.direction, b * axis.spacing), upper, lower, &points);
+
+            if (!lower.is_empty()) {
+                coords[axis_idx] = b - 1;
+                dice_polygon(state, lower, axis_idx + 1, coords);
+            }
+
+            remaining = upper;
+        }
+
+        if (!remaining.is_empty()) {
+            coords[axis_idx] = last;
+            dice_polygon(state, remaining, axis_idx + 1, coords);
+        }
+    }
+
+    /**
+     * Fills in the cross sections along one of the interior boundaries. The cross section is
+     * built once for the whole boundary and then clipped down to the side of each pair of cells
+     * that share it
+    */
+    void add_boundary_cross_sections(DiceState &state, int axis_idx, int boundary, Rect2 uv_rect) {
+        const Axis &axis = (*state.axes)[axis_idx];
+        const Vector<Vector3> &points = state.boundary_points[axis_idx][boundary - state.min_slab[axis_idx] - 1];
+        if (points.size() < 3) {
+            return;
+        }
+
+        Vector<SlicerFace> cross_section = Triangulator::monotone_chain(points, axis.direction, uv_rect);
+        if (cross_section.size() == 0) {
+            return;
+        }
+
+        Vector<ClipPolygon> polygons;
+        {
+            const SlicerFace *cross_section_reader = cross_section.ptr();
+            for (int i = 0; i < cross_section.size(); i++) {
+                polygons.push_back(ClipPolygon::from_face(cross_section_reader[i]));
+            }
+        }
+
+        int axis_count = state.axes->size();
+        for (int cell_idx = 0; cell_idx < state.cells.size(); cell_idx++) {
+            int coords[3];
+            for (int i = 0; i < axis_count; i++) {
+                coords[i] = (cell_idx / state.stride[i]) % state.slab_count[i] + state.min_slab[i];
+            }
+
+            // We only want the cells sitting right below the boundary, each of which
+            // shares its side with the cell right above it
+            if (coords[axis_idx] != boundary - 1) {
+                continue;
+            }
+
+            // The side of the cell is bounded by the slabs the cell sits in along the other
+            // axes. There's nothing past the outermost slabs so they don't need to be clipped
+            Plane sides[4];
+            int side_count = 0;
+            for (int i = 0; i < axis_count; i++) {
+                if (i == axis_idx) {
+                    continue;
+                }
+
+                const Axis &other = (*state.axes)[i];
+                if (coords[i] > state.min_slab[i]) {
+                    sides[side_count++] = Plane(-other.direction, -coords[i] * other.spacing);
+                }
+
+                if (coords[i] < state.max_slab(i)) {
+                    sides[side_count++] = Plane(other.direction, (coords[i] + 1) * other.spacing);
+                }
+            }
+
+            CellMesh &lower = state.cells.ptrw()[cell_idx];
+            CellMesh &upper = state.cells.ptrw()[cell_idx + state.stride[axis_idx]];
+
+            for (int i = 0; i < polygons.size(); i++) {
+                ClipPolygon polygon = polygons[i];
+                for (int j = 0; j < side_count && !polygon.is_empty(); j++) {
+                    ClipPolygon inside;
+                    polygon.clip(sides[j], inside);
+                    polygon = inside;
+                }
+
+                // Same winding as SlicedMesh gives the lower and upper halves of a slice
+                polygon.triangulate(lower.cross_section_faces);
+                polygon.triangulate(upper.cross_section_faces, true);
+            }
+        }
+    }
+
+    Vector<CellMesh> dice(const Vector<SourceSurface> &sources, const Vector<Axis> &axes, Rect2 uv_rect, Grid *r_grid) {
+        ERR_FAIL_COND_V(axes.size() < 1 || axes.size() > 3, Vector<CellMesh>());
+        for (int i = 0; i < axes.size(); i++) {
+            ERR_FAIL_COND_V(axes[i].direction == Vector3(), Vector<CellMesh>());
+            ERR_FAIL_COND_V(axes[i].spacing <= 0, Vector<CellMesh>());
+        }
+
+        DiceState state;
+        state.axes = &axes;
+
+        // Figure out which slabs the mesh actually covers so we don't end
+        // up allocating cells for the whole of the (infinite) grid
+        bool has_faces = false;
+        real_t min_dists[3] = { 0, 0, 0 };
+        real_t max_dists[3] = { 0, 0, 0 };
+        for (int i = 0; i < sources.size(); i++) {
+            const SlicerFace *faces_reader = sources[i].faces.ptr();
+            for (int j = 0; j < sources[i].faces.size(); j++) {
+                for (int k = 0; k < 3; k++) {
+                    for (int a = 0; a < axes.size(); a++) {
+                        real_t dist = axes[a].direction.dot(faces_reader[j].vertex[k]);
+                        min_dists[a] = has_faces ? MIN(min_dists[a], dist) : dist;
+                        max_dists[a] = has_faces ? MAX(max_dists[a], dist) : dist;
+                    }
+                    has_faces = true;
+                }
+            }
+        }
+
+        if (!has_faces) {
+            return Vector<CellMesh>();
+        }
+
+        uint64_t cell_count = 1;
+        for (int a = 0; a < axes.size(); a++) {
+            // Vertexes sitting right on the outermost boundaries shouldn't
+            // create slabs that nothing but a sliver of the mesh falls into
+            int min_slab = (int)Math::floor((min_dists[a] + CMP_EPSILON) / axes[a].spacing);
+            int max_slab = MAX((int)Math::ceil((max_dists[a] - CMP_EPSILON) / axes[a].spacing) - 1, min_slab);
+
+            state.min_slab[a] = min_slab;
+            state.slab_count[a] = max_slab - min_slab + 1;
+            state.stride[a] = cell_count;
+            state.boundary_points[a].resize(state.slab_count[a] - 1);
+
+            cell_count *= state.slab_count[a];
+            ERR_FAIL_COND_V_MSG(cell_count > MAX_CELLS, Vector<CellMesh>(), "Dicing would create too many cells. Try a larger spacing.");
+        }
+
+        state.cells.resize(cell_count);
+        for (int i = 0; i < state.cells.size(); i++) {
+            state.cells.ptrw()[i] = CellMesh(sources.size());
+        }
+
+        for (int i = 0; i < sources.size(); i++) {
+            state.surface_idx = i;
+            const SlicerFace *faces_reader = sources[i].faces.ptr();
+
+            for (int j = 0; j < sources[i].faces.size(); j++) {
+                const SlicerFace &face = faces_reader[j];
+
+                // Most faces won't touch a boundary at all, in which case they can be
+                // passed through whole rather than be taken apart and put back together
+                int coords[3];
+                bool crosses = false;
+                for (int a = 0; a < axes.size() && !crosses; a++) {
+                    real_t dist0 = axes[a].direction.dot(face.vertex[0]);
+                    real_t dist1 = axes[a].direction.dot(face.vertex[1]);
+                    real_t dist2 = axes[a].direction.dot(face.vertex[2]);
+                    real_t min_dist = MIN(MIN(dist0, dist1), dist2);
+                    real_t max_dist = MAX(MAX(dist0, dist1), dist2);
+
+                    int first;
+                    int last;
+                    crosses = get_boundaries(state, a, min_dist, max_dist, first, last);
+                    coords[a] = get_slab(state, a, min_dist, max_dist);
+                }
+
+                if (crosses) {
+                    dice_polygon(state, ClipPolygon::from_face(face), 0, coords);
+                } else {
+                    state.cells.ptrw()[state.cell_index(coords)].surface_faces.ptrw()[i].push_back(face);
+                }
+            }
+        }
+
+        for (int a = 0; a < axes.size(); a++) {
+            for (int b = state.min_slab[a] + 1; b <= state.max_slab(a); b++) {
+                add_boundary_cross_sections(state, a, b, uv_rect);
+            }
+        }
+
+        if (r_grid) {
+            *r_grid = Grid();
+            for (int a = 0; a < axes.size(); a++) {
+                r_grid->min_slab[a] = state.min_slab[a];
+                r_grid->slab_count[a] = state.slab_count[a];
+            }
+        }
+
+        return state.cells;
+    }
+} // Dicer
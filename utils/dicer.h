@@ -0,0 +1,72 @@
+#ifndef DICER_H
+#define DICER_H
+
+#include "cell_mesh.h"
+#include "clip_polygon.h"
+
+/**
+ * Contains functions for cutting a mesh into a regular series of slabs or
+ * a grid of cells in one go, rather than slicing it over and over
+*/
+namespace Dicer {
+    /**
+     * A direction that a mesh is being diced along. Cuts are made every
+     * `spacing` units along the direction, starting from the origin
+    */
+    struct Axis {
+        Vector3 direction;
+        real_t spacing;
+
+        Axis() {
+            spacing = 1;
+        }
+
+        Axis(Vector3 p_direction, real_t p_spacing) {
+            direction = p_direction.normalized();
+            spacing = p_spacing;
+        }
+    };
+
+    // Dicing a mesh into more cells than this is almost certainly a mistake
+    // (such as a tiny spacing) rather than something that was intended
+    const int MAX_CELLS = 1 << 16;
+
+    /**
+     * Where the cells handed back by dice sit. Along each axis the mesh covers slab_count
+     * slabs starting from slab min_slab, where slab n lies between n * spacing and
+     * (n + 1) * spacing. Axes that weren't diced along are a single slab at 0
+    */
+    struct Grid {
+        int min_slab[3];
+        int slab_count[3];
+
+        Grid() {
+            for (int i = 0; i < 3; i++) {
+                min_slab[i] = 0;
+                slab_count[i] = 1;
+            }
+        }
+
+        /**
+         * The slab a cell sits in along one of the axes
+        */
+        int get_slab(int cell_idx, int axis_idx) const {
+            int stride = 1;
+            for (int i = 0; i < axis_idx; i++) {
+                stride *= slab_count[i];
+            }
+            return (cell_idx / stride) % slab_count[axis_idx] + min_slab[axis_idx];
+        }
+    };
+
+    /**
+     * Dices every source surface along all of the passed in axes (up to 3) in a single pass. Each
+     * face is only cut by the boundaries it actually crosses and every cell gets cross sections
+     * for each of its sides the mesh passes through. Cells are laid out with the first axis
+     * varying the fastest and are left empty if no part of the mesh falls into them. If r_grid
+     * is given it's filled in with which slabs the cells cover
+    */
+    Vector<CellMesh> dice(const Vector<SourceSurface> &sources, const Vector<Axis> &axes, Rect2 uv_rect = Rect2(0, 0, 1, 1), Grid *r_grid = NULL);
+} // Dicer
+
+#endif // DICER_H
@@ -0,0 +1,182 @@
+#ifndef FACE_BVH_H
+#define FACE_BVH_H
+
+#include <algorithm>
+#include "intersector.h"
+
+/**
+ * A bounding volume hierarchy over the faces of a surface. Slicing is normally
+ * linear in the amount of faces even though only the faces that straddle the plane
+ * actually need to be cut. Once a BVH has been built, any node whose bounds fall
+ * entirely on one side of the plane can have all of its faces passed along as they
+ * are, leaving only the leaves that straddle the plane to go through
+ * Intersector::split_face_by_plane.
+ *
+ * Building is a good deal more expensive than a single slice, so this is only
+ * worth it for meshes that get cut more than once (see Slicer's decomposition cache)
+*/
+struct FaceBVH {
+    // Leaves larger than this will be subdivided
+    static const int MAX_LEAF_FACES = 8;
+
+    struct Node {
+        AABB aabb;
+
+        // The range of faces (once they've been reordered by build) covered by this node
+        int start;
+        int count;
+
+        // Children indexes, or -1 for leaves
+        int left;
+        int right;
+    };
+
+    Vector<Node> nodes;
+
+    /**
+     * Builds the hierarchy, reordering the passed in faces so that every node
+     * covers a contiguous range of them
+    */
+    void build(Vector<SlicerFace> &faces) {
+        nodes.clear();
+        if (faces.size() == 0) {
+            return;
+        }
+
+        Vector<int> order;
+        Vector<Vector3> centroids;
+        order.resize(faces.size());
+        centroids.resize(faces.size());
+
+        {
+            const SlicerFace *faces_reader = faces.ptr();
+            for (int i = 0; i < faces.size(); i++) {
+                order.ptrw()[i] = i;
+                centroids.ptrw()[i] = (faces_reader[i].vertex[0] + faces_reader[i].vertex[1] + faces_reader[i].vertex[2]) / 3.0;
+            }
+
+            build_node(faces_reader, centroids.ptr(), order.ptrw(), 0, faces.size());
+        }
+
+        Vector<SlicerFace> ordered;
+        ordered.resize(faces.size());
+        const SlicerFace *faces_reader = faces.ptr();
+        SlicerFace *ordered_writer = ordered.ptrw();
+        for (int i = 0; i < faces.size(); i++) {
+            ordered_writer[i] = faces_reader[order[i]];
+        }
+
+        faces = ordered;
+    }
+
+    bool is_built() const {
+        return nodes.size() > 0;
+    }
+
+    /**
+     * Does the same thing as running every face through Intersector::split_face_by_plane,
+     * but only for faces that are in nodes straddling the plane. faces should be the same
+     * vector that was passed into build
+    */
+    void split_by_plane(const Plane &plane, const Vector<SlicerFace> &faces, Intersector::SplitResult &result) const {
+        ERR_FAIL_COND(!is_built());
+
+        const SlicerFace *faces_reader = faces.ptr();
+
+        // The tree is roughly balanced so this won't come anywhere near being filled
+        int stack[64];
+        int stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size > 0) {
+            const Node &node = nodes[stack[--stack_size]];
+
+            // Project the box onto the plane's normal to find the closest
+            // and furthest any of its faces' vertexes could possibly be
+            Vector3 half_size = node.aabb.size * 0.5;
+            real_t center_dist = plane.distance_to(node.aabb.position + half_size);
+            real_t radius = ABS(half_size.x * plane.normal.x) + ABS(half_size.y * plane.normal.y) + ABS(half_size.z * plane.normal.z);
+
+            if (center_dist - radius > CMP_EPSILON) {
+                if (result.keep_upper) {
+                    append_range(result.upper_faces, faces_reader, node.start, node.count);
+                }
+            } else if (center_dist + radius < -CMP_EPSILON) {
+                if (result.keep_lower) {
+                    append_range(result.lower_faces, faces_reader, node.start, node.count);
+                }
+            } else if (node.left < 0) {
+                for (int i = node.start; i < node.start + node.count; i++) {
+                    Intersector::split_face_by_plane(plane, faces_reader[i], result);
+                }
+            } else {
+                ERR_FAIL_COND(stack_size + 2 > 64);
+                stack[stack_size++] = node.right;
+                stack[stack_size++] = node.left;
+            }
+        }
+    }
+
+private:
+    struct CentroidComparator {
+        const Vector3 *centroids;
+        int axis;
+
+        bool operator()(int a, int b) const {
+            return centroids[a][axis] < centroids[b][axis];
+        }
+    };
+
+    int build_node(const SlicerFace *faces_reader, const Vector3 *centroids, int *order, int start, int count) {
+        int node_idx = nodes.size();
+        nodes.push_back(Node());
+
+        AABB aabb(faces_reader[order[start]].vertex[0], Vector3());
+        AABB centroid_bounds(centroids[order[start]], Vector3());
+        for (int i = start; i < start + count; i++) {
+            for (int j = 0; j < 3; j++) {
+                aabb.expand_to(faces_reader[order[i]].vertex[j]);
+            }
+            centroid_bounds.expand_to(centroids[order[i]]);
+        }
+
+        int left = -1;
+        int right = -1;
+
+        // Split along the median of the longest axis of the faces' centers. If they're all
+        // stacked on top of each other there's no way to divide them so they stay as one leaf
+        if (count > MAX_LEAF_FACES && centroid_bounds.get_longest_axis_size() > 0) {
+            CentroidComparator comparator;
+            comparator.centroids = centroids;
+            comparator.axis = centroid_bounds.get_longest_axis_index();
+
+            int half = count / 2;
+            std::nth_element(order + start, order + start + half, order + start + count, comparator);
+
+            left = build_node(faces_reader, centroids, order, start, half);
+            right = build_node(faces_reader, centroids, order, start + half, count - half);
+        }
+
+        // Children may have reallocated our node so it can only be filled in now
+        Node &node = nodes.ptrw()[node_idx];
+        node.aabb = aabb;
+        node.start = start;
+        node.count = count;
+        node.left = left;
+        node.right = right;
+
+        return node_idx;
+    }
+
+    static void append_range(Vector<SlicerFace> &dest, const SlicerFace *faces_reader, int start, int count) {
+        int size = dest.size();
+        dest.resize(size + count);
+
+        SlicerFace *dest_writer = dest.ptrw();
+        for (int i = 0; i < count; i++) {
+            dest_writer[size + i] = faces_reader[start + i];
+        }
+    }
+};
+
+#endif // FACE_BVH_H
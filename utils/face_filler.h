@@ -14,7 +14,7 @@ _FORCE_INLINE_ Vector3 snap_vertex(Vector3 v) {
  * maintaining info about things such as normals and uvs etc.
 */
 struct FaceFiller {
-    PoolVector<SlicerFace>::Write faces_writer;
+    SlicerFace *faces_writer;
     PoolVector<Vector3>::Read vertices_reader;
 
     bool has_normals;
@@ -39,8 +39,8 @@ struct FaceFiller {
     PoolVector<Vector2>::Read uv2s_reader;
 
     // Yuck. What an eye sore this constructor is
-    FaceFiller(PoolVector<SlicerFace> &faces, const Array &surface_arrays) {
-        faces_writer = faces.write();
+    FaceFiller(Vector<SlicerFace> &faces, const Array &surface_arrays) {
+        faces_writer = faces.ptrw();
 
         PoolVector<Vector3> vertices = surface_arrays[Mesh::ARRAY_VERTEX];
         vertices_reader = vertices.read();
@@ -101,6 +101,7 @@ struct FaceFiller {
         }
 
         faces_writer[face_idx].vertex[set_offset] = snap_vertex(vertices_reader[lookup_idx]);
+        faces_writer[face_idx].source_index[set_offset] = lookup_idx;
 
         if (has_normals) {
             faces_writer[face_idx].normal[set_offset] = normals_reader[lookup_idx];
@@ -145,10 +146,6 @@ struct FaceFiller {
             faces_writer[face_idx].uv2[set_offset] = uv2s_reader[lookup_idx];
         }
     }
-
-    ~FaceFiller() {
-        faces_writer.release();
-    }
 };
 
 #endif // FACE_FILLER_H
@@ -2,57 +2,102 @@
 
 namespace Intersector {
     /**
-     * FaceIntersectInfo is one place where we, superficially, deviate from the original
-     * Ezy-Slice implementation. The idea is to generalize the plane-face relationship as
-     * much as possible to try to reduce long series of conditionals with largely similar
-     * blocks for code and hopefully make the actual process that's happening a bit easier
-     * to grok.
+     * Describes what a face turns into for one combination of the sides of the plane its vertexes
+     * fall on. This is, superficially, another place where we deviate from Ezy-Slice: rather than
+     * working through a series of edge cases (is everything on one side? is one side parallel? etc)
+     * and then figuring out which vertex is which, every one of the 27 possible combinations is
+     * worked out ahead of time in SPLIT_CASES below, so a split is just a lookup and a loop.
+     *
+     * Triangles are described by corner indexes: 0-2 are the face's own vertexes and 3-4 are the
+     * points where the listed edges cross the plane. Triangles are already wound clockwise,
+     * matching the face they were cut from, so they render correctly
     */
-    struct FaceIntersectInfo {
-        SideOfPlane sides[3];
+    struct SplitCase {
+        // Each edge goes from the vertex being kept to the vertex being cut away
+        uint8_t edge_count;
+        uint8_t edges[2][2];
 
-        int num_of_points_above;
-        Vector3 points_above[3];
+        // The corners that lie on the plane and make up the cross section
+        uint8_t point_count;
+        uint8_t points[3];
 
-        int num_of_points_below;
-        Vector3 points_below[3];
+        uint8_t upper_count;
+        uint8_t upper[2][3];
 
-        int num_of_points_on;
-        Vector3 points_on[3];
-
-        FaceIntersectInfo(const Plane &plane, const SlicerFace &face) {
-            num_of_points_above = 0;
-            num_of_points_below = 0;
-            num_of_points_on = 0;
+        uint8_t lower_count;
+        uint8_t lower[2][3];
+    };
 
-            SideOfPlane sides_of[3] = {
-                get_side_of(plane, face.vertex[0]),
-                get_side_of(plane, face.vertex[1]),
-                get_side_of(plane, face.vertex[2])
-            };
+    // Indexed by get_side_of(vertex[0]) * 9 + get_side_of(vertex[1]) * 3 + get_side_of(vertex[2])
+    static const SplitCase SPLIT_CASES[27] = {
+        // OVER, OVER, OVER
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 1, { { 0, 1, 2 }, { 0, 0, 0 } }, 0, { { 0, 0, 0 }, { 0, 0, 0 } } },
+        // OVER, OVER, UNDER
+        { 2, { { 0, 2 }, { 1, 2 } }, 2, { 3, 4, 0 }, 2, { { 0, 4, 3 }, { 1, 4, 0 } }, 1, { { 2, 3, 4 }, { 0, 0, 0 } } },
+        // OVER, OVER, ON
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 1, { { 0, 1, 2 }, { 0, 0, 0 } }, 0, { { 0, 0, 0 }, { 0, 0, 0 } } },
+        // OVER, UNDER, OVER
+        { 2, { { 0, 1 }, { 2, 1 } }, 2, { 3, 4, 0 }, 2, { { 2, 3, 4 }, { 0, 3, 2 } }, 1, { { 1, 4, 3 }, { 0, 0, 0 } } },
+        // OVER, UNDER, UNDER
+        { 2, { { 1, 0 }, { 2, 0 } }, 2, { 3, 4, 0 }, 1, { { 0, 3, 4 }, { 0, 0, 0 } }, 2, { { 1, 4, 3 }, { 2, 4, 1 } } },
+        // OVER, UNDER, ON
+        { 1, { { 0, 1 }, { 0, 0 } }, 2, { 2, 3, 0 }, 1, { { 2, 0, 3 }, { 0, 0, 0 } }, 1, { { 2, 3, 1 }, { 0, 0, 0 } } },
+        // OVER, ON, OVER
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 1, { { 0, 1, 2 }, { 0, 0, 0 } }, 0, { { 0, 0, 0 }, { 0, 0, 0 } } },
+        // OVER, ON, UNDER
+        { 1, { { 0, 2 }, { 0, 0 } }, 2, { 1, 3, 0 }, 1, { { 1, 3, 0 }, { 0, 0, 0 } }, 1, { { 1, 2, 3 }, { 0, 0, 0 } } },
+        // OVER, ON, ON
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 1, { { 0, 1, 2 }, { 0, 0, 0 } }, 0, { { 0, 0, 0 }, { 0, 0, 0 } } },
+        // UNDER, OVER, OVER
+        { 2, { { 1, 0 }, { 2, 0 } }, 2, { 3, 4, 0 }, 2, { { 1, 4, 3 }, { 2, 4, 1 } }, 1, { { 0, 3, 4 }, { 0, 0, 0 } } },
+        // UNDER, OVER, UNDER
+        { 2, { { 0, 1 }, { 2, 1 } }, 2, { 3, 4, 0 }, 1, { { 1, 4, 3 }, { 0, 0, 0 } }, 2, { { 2, 3, 4 }, { 0, 3, 2 } } },
+        // UNDER, OVER, ON
+        { 1, { { 1, 0 }, { 0, 0 } }, 2, { 2, 3, 0 }, 1, { { 2, 3, 1 }, { 0, 0, 0 } }, 1, { { 2, 0, 3 }, { 0, 0, 0 } } },
+        // UNDER, UNDER, OVER
+        { 2, { { 0, 2 }, { 1, 2 } }, 2, { 3, 4, 0 }, 1, { { 2, 3, 4 }, { 0, 0, 0 } }, 2, { { 0, 4, 3 }, { 1, 4, 0 } } },
+        // UNDER, UNDER, UNDER
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 0, { { 0, 0, 0 }, { 0, 0, 0 } }, 1, { { 0, 1, 2 }, { 0, 0, 0 } } },
+        // UNDER, UNDER, ON
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 0, { { 0, 0, 0 }, { 0, 0, 0 } }, 1, { { 0, 1, 2 }, { 0, 0, 0 } } },
+        // UNDER, ON, OVER
+        { 1, { { 2, 0 }, { 0, 0 } }, 2, { 1, 3, 0 }, 1, { { 1, 2, 3 }, { 0, 0, 0 } }, 1, { { 1, 3, 0 }, { 0, 0, 0 } } },
+        // UNDER, ON, UNDER
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 0, { { 0, 0, 0 }, { 0, 0, 0 } }, 1, { { 0, 1, 2 }, { 0, 0, 0 } } },
+        // UNDER, ON, ON
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 0, { { 0, 0, 0 }, { 0, 0, 0 } }, 1, { { 0, 1, 2 }, { 0, 0, 0 } } },
+        // ON, OVER, OVER
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 1, { { 0, 1, 2 }, { 0, 0, 0 } }, 0, { { 0, 0, 0 }, { 0, 0, 0 } } },
+        // ON, OVER, UNDER
+        { 1, { { 1, 2 }, { 0, 0 } }, 2, { 0, 3, 0 }, 1, { { 0, 1, 3 }, { 0, 0, 0 } }, 1, { { 0, 3, 2 }, { 0, 0, 0 } } },
+        // ON, OVER, ON
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 1, { { 0, 1, 2 }, { 0, 0, 0 } }, 0, { { 0, 0, 0 }, { 0, 0, 0 } } },
+        // ON, UNDER, OVER
+        { 1, { { 2, 1 }, { 0, 0 } }, 2, { 0, 3, 0 }, 1, { { 0, 3, 2 }, { 0, 0, 0 } }, 1, { { 0, 1, 3 }, { 0, 0, 0 } } },
+        // ON, UNDER, UNDER
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 0, { { 0, 0, 0 }, { 0, 0, 0 } }, 1, { { 0, 1, 2 }, { 0, 0, 0 } } },
+        // ON, UNDER, ON
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 0, { { 0, 0, 0 }, { 0, 0, 0 } }, 1, { { 0, 1, 2 }, { 0, 0, 0 } } },
+        // ON, ON, OVER
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 1, { { 0, 1, 2 }, { 0, 0, 0 } }, 0, { { 0, 0, 0 }, { 0, 0, 0 } } },
+        // ON, ON, UNDER
+        { 0, { { 0, 0 }, { 0, 0 } }, 0, { 0, 0, 0 }, 0, { { 0, 0, 0 }, { 0, 0, 0 } }, 1, { { 0, 1, 2 }, { 0, 0, 0 } } },
+        // ON, ON, ON
+        { 0, { { 0, 0 }, { 0, 0 } }, 3, { 0, 1, 2 }, 0, { { 0, 0, 0 }, { 0, 0, 0 } }, 0, { { 0, 0, 0 }, { 0, 0, 0 } } },
+    };
 
-            for (int i = 0; i < 3; i++) {
-                SideOfPlane side = sides_of[i];
-                sides[i] = side;
+    // The general and axis aligned splits only differ in how they measure distances, so
+    // everything below is written against these and instantiated once for each
+    _FORCE_INLINE_ real_t along_normal(const Plane &plane, const Vector3 &vec) {
+        return plane.normal.dot(vec);
+    }
 
-                if (side == SideOfPlane::OVER)
-                    points_above[num_of_points_above++] = face.vertex[i];
-                else if (side == SideOfPlane::UNDER)
-                    points_below[num_of_points_below++] = face.vertex[i];
-                else
-                    points_on[num_of_points_on++] = face.vertex[i];
-            }
-        }
-    };
+    _FORCE_INLINE_ real_t along_normal(const AxisPlane &plane, const Vector3 &vec) {
+        return plane.along_normal(vec);
+    }
 
-    // Similar to Face3::get_side_of but focused on a single point
-    // rather than an entire face. Plane has a `is_point_over` method but
-    // this doesn't give us enough information to know if the point is
-    // actually laying on the plane without having to do an additional
-    // calculation in Plane::has_point. The logic is so straightforward
-    // I don't think we need to feel too bad about reimplementing to meet
-    // our exact needs
-    SideOfPlane get_side_of(const Plane &plane, Vector3 point) {
+    template <class P>
+    _FORCE_INLINE_ SideOfPlane side_of(const P &plane, const Vector3 &point) {
         real_t dist = plane.distance_to(point);
         if (dist > CMP_EPSILON) {
             return SideOfPlane::OVER;
@@ -65,220 +110,91 @@ namespace Intersector {
         return SideOfPlane::ON;
     }
 
-    bool line_intersects(const Plane &plane, const Vector3 a, const Vector3 b, Vector3 &out) {
-        Vector3 ab = b - a;
-        real_t t = (plane.d - plane.normal.dot(a)) / (plane.normal.dot(ab));
-
-        if (t >= CMP_EPSILON && t <= (1 + CMP_EPSILON)) {
-            Vector3 intersect_point = a + t * ab;
-            out.x = intersect_point.x;
-            out.y = intersect_point.y;
-            out.z = intersect_point.z;
-
-            return true;
-        }
-        return false;
+    // Similar to Face3::get_side_of but focused on a single point
+    // rather than an entire face. Plane has a `is_point_over` method but
+    // this doesn't give us enough information to know if the point is
+    // actually laying on the plane without having to do an additional
+    // calculation in Plane::has_point. The logic is so straightforward
+    // I don't think we need to feel too bad about reimplementing to meet
+    // our exact needs
+    SideOfPlane get_side_of(const Plane &plane, Vector3 point) {
+        return side_of(plane, point);
     }
 
-    bool points_all_on_same_side(const SlicerFace &face, FaceIntersectInfo &info, SplitResult &result) {
-        // This is actually a bit of a divergence from Ezy-Slice, where instead they just return and then handle
-        // this case in a different loop. With the way we have things setup though I think we can just handle them
-        // while we're here with all of already deduced info
-        if (info.num_of_points_above == 3) {
-            result.upper_faces.push_back(face);
-            return true;
-        } else if (info.num_of_points_below == 3) {
-            result.lower_faces.push_back(face);
-            return true;
-        } else if (info.num_of_points_on == 3) {
-            result.intersection_points.push_back(face.vertex[0]);
-            result.intersection_points.push_back(face.vertex[1]);
-            result.intersection_points.push_back(face.vertex[2]);
-            return true;
-        }
-
-        return false;
-    }
+    /**
+     * Finds where the edge between the given vertexes of a face crosses the plane and stores
+     * it, along with all of its interpolated data, in the idx vertex of out
+    */
+    template <class P>
+    bool edge_intersects(const P &plane, const SlicerFace &face, int from, int to, SlicerFace &out, int idx) {
+        Vector3 a = face.vertex[from];
+        Vector3 ab = face.vertex[to] - a;
+        real_t t = (plane.d - along_normal(plane, a)) / along_normal(plane, ab);
 
-    bool one_side_is_parallel(const SlicerFace &face, FaceIntersectInfo &info, SplitResult &result) {
-        // if two points are actually lying *on* the plane then we know there won't be any real intersection,
-        // we can just reuse the facd as is after determining if the remaining point is above or below the plane
-        if (info.num_of_points_on == 2) {
-            if (info.num_of_points_above == 1) {
-                result.upper_faces.push_back(face);
-            } else {
-                result.lower_faces.push_back(face);
-            }
+        if (t >= CMP_EPSILON && t <= (1 + CMP_EPSILON)) {
+            out.set_vertex_between(idx, face, from, to, t);
             return true;
         }
-
         return false;
     }
 
-    bool pointed_away(const SlicerFace &face, FaceIntersectInfo &info, SplitResult &result) {
-        // Similar to one_side_is_parallel except in this case only one point is on the plane
-        // and the other 2 are on the same side
-        if (info.num_of_points_on == 1) {
-            if (info.num_of_points_above == 2) {
-                result.upper_faces.push_back(face);
-                return true;
-            } else if (info.num_of_points_below == 2) {
-                result.lower_faces.push_back(face);
-                return true;
+    // Face3 has its own split_by_plane but we need to make a few modifications to support
+    // all the data that SlicerFace is responsible for holding. Also Ezy-Slice uses a few clever
+    // tricks to handle edge cases
+    //
+    // Having result passed in and filled out by reference should hopefully allow us to reuse
+    // the same one over a series of faces
+    template <class P>
+    void split_face(const P &plane, const SlicerFace &face, SplitResult &result) {
+        const SplitCase &split_case = SPLIT_CASES[
+            side_of(plane, face.vertex[0]) * 9 +
+            side_of(plane, face.vertex[1]) * 3 +
+            side_of(plane, face.vertex[2])
+        ];
+
+        // Holds the points where the plane crosses the face's edges
+        SlicerFace cut;
+        for (int i = 0; i < split_case.edge_count; i++) {
+            if (!edge_intersects(plane, face, split_case.edges[i][0], split_case.edges[i][1], cut, i)) {
+                ERR_FAIL();
             }
         }
 
-        return false;
-    }
-
-    bool face_split_in_half(const Plane &plane, const SlicerFace &face, FaceIntersectInfo &info, SplitResult &result) {
-        // If one point is lying on the plane and the other 2 points are on either side all we really need to do is split
-        // the triangle in half (or, more accurately, in two)
-        if (info.num_of_points_on == 1) {
-            Vector3 on = info.points_on[0];
-
-            // We know that there is one on either side or else it would have been caught in `pointed_away`
-            ERR_FAIL_COND_V(info.num_of_points_above != 1 || info.num_of_points_below != 1, false);
-            Vector3 above = info.points_above[0];
-            Vector3 below = info.points_below[0];
-
-            Vector3 a = face.vertex[0];
-            Vector3 b = face.vertex[1];
-            Vector3 c = face.vertex[2];
+        for (int i = 0; i < split_case.point_count; i++) {
+            int corner = split_case.points[i];
+            result.intersection_points.push_back(corner < 3 ? face.vertex[corner] : cut.vertex[corner - 3]);
+        }
 
-            Vector3 intersect_point;
-            if (!line_intersects(plane, above, below, intersect_point)) {
-                ERR_FAIL_V(false);
+        for (int i = 0; i < split_case.upper_count + split_case.lower_count; i++) {
+            bool is_upper = i < split_case.upper_count;
+            if (!(is_upper ? result.keep_upper : result.keep_lower)) {
+                continue;
             }
 
-            result.intersection_points.push_back(on);
-            result.intersection_points.push_back(intersect_point);
+            const uint8_t *corners = is_upper ? split_case.upper[i] : split_case.lower[i - split_case.upper_count];
 
-            SlicerFace upper_face;
-            SlicerFace lower_face;
+            SlicerFace new_face;
+            for (int j = 0; j < 3; j++) {
+                if (corners[j] < 3) {
+                    new_face.set_vertex_from(j, face, corners[j]);
+                } else {
+                    new_face.set_vertex_from(j, cut, corners[j] - 3);
+                }
+            }
 
-            // We need to make sure, for any new triangle we're generating, that the points are created clockwise so that
-            // the face renders correctly. Sadly our FaceIntersectInfo helper fails us here and we need to fall back on
-            // tedious conditionals to manually handle this logic. I'd really love a way of reliably generalizing this
-            if (on == a) {
-                upper_face = face.sub_face(a, b, intersect_point);
-                lower_face = face.sub_face(a, intersect_point, c);
-            } else if (on == b) {
-                upper_face = face.sub_face(b, c, intersect_point);
-                lower_face = face.sub_face(b, intersect_point, a);
+            if (is_upper) {
+                result.upper_faces.push_back(new_face);
             } else {
-                upper_face = face.sub_face(c, a, intersect_point);
-                lower_face = face.sub_face(c, intersect_point, b);
+                result.lower_faces.push_back(new_face);
             }
-
-            result.upper_faces.push_back(upper_face);
-            result.lower_faces.push_back(lower_face);
-
-            return true;
         }
-
-        return false;
     }
 
-    void full_split(const Plane &plane, const SlicerFace &face, FaceIntersectInfo &info, SplitResult &result) {
-        // at this point, all edge cases have been tested and failed, we need to perform
-        // full intersection tests against the lines. From this point onwards we will generate
-        // 3 triangles
-        ERR_FAIL_COND(info.num_of_points_on != 0);
-        ERR_FAIL_COND(info.num_of_points_above == 0);
-        ERR_FAIL_COND(info.num_of_points_below == 0);
-
-        Vector3 a = face.vertex[0];
-        Vector3 b = face.vertex[1];
-        Vector3 c = face.vertex[2];
-
-        // If we've gotten to this point then we can be able to confidently say that two points lie on one side
-        // and one point lies on the other. We just need to find out which is which;
-        Vector3 on_same_side_1;
-        Vector3 on_same_side_2;
-        Vector3 on_lone_side;
-
-        if (info.num_of_points_above == 2) {
-            on_same_side_1 = info.points_above[0];
-            on_same_side_2 = info.points_above[1];
-            on_lone_side = info.points_below[0];
-        } else if (info.num_of_points_below == 2) {
-            on_same_side_1 = info.points_below[0];
-            on_same_side_2 = info.points_below[1];
-            on_lone_side = info.points_above[0];
-        } else {
-            ERR_FAIL_MSG("Slicer's full_split method was called with unexpected intersection info");
-        }
-
-        Vector3 intersection_point_1;
-        Vector3 intersection_point_2;
-        if (!line_intersects(plane, on_same_side_1, on_lone_side, intersection_point_1) ||
-            !line_intersects(plane, on_same_side_2, on_lone_side, intersection_point_2)) {
-            ERR_FAIL();
-        }
-
-        SlicerFace lone_tri;
-        SlicerFace same_tri_1;
-        SlicerFace same_tri_2;
-
-        // As mentioned in face_split_in_half, we need to make sure that we add our points
-        // clockwise or else it won't render correctly. I'd love some way of generalizing this
-        // to be less redundent
-        if (on_lone_side == a) {
-            lone_tri = face.sub_face(a, intersection_point_1, intersection_point_2);
-            same_tri_1 = face.sub_face(b, intersection_point_2, intersection_point_1);
-            same_tri_2 = face.sub_face(c, intersection_point_2, b);
-        } else if (on_lone_side == b) {
-            lone_tri = face.sub_face(b, intersection_point_2, intersection_point_1);
-            same_tri_1 = face.sub_face(c, intersection_point_1, intersection_point_2);
-            same_tri_2 = face.sub_face(a, intersection_point_1, c);
-        } else {
-            lone_tri = face.sub_face(c, intersection_point_1, intersection_point_2);
-            same_tri_1 = face.sub_face(a, intersection_point_2, intersection_point_1);
-            same_tri_2 = face.sub_face(b, intersection_point_2, a);
-        }
-
-        if (info.num_of_points_above == 2) {
-            result.upper_faces.push_back(same_tri_1);
-            result.upper_faces.push_back(same_tri_2);
-            result.lower_faces.push_back(lone_tri);
-        } else {
-            result.lower_faces.push_back(same_tri_1);
-            result.lower_faces.push_back(same_tri_2);
-            result.upper_faces.push_back(lone_tri);
-
-        }
-
-        result.intersection_points.push_back(intersection_point_1);
-        result.intersection_points.push_back(intersection_point_2);
-    }
-
-    // Face3 has its own split_by_plane but we need to make a few modifications to support
-    // all the data that SlicerFace is responsible for holding. Also Ezy-Slice uses a few clever
-    // tricks to handle edge cases
-    //
-    // Having result passed in and filled out by reference should hopefully allow us to reuse
-    // the same one over a series of faces
     void split_face_by_plane(const Plane &plane, const SlicerFace &face, SplitResult &result) {
-        FaceIntersectInfo info(plane, face);
-
-        if (points_all_on_same_side(face, info, result)) {
-            return;
-        }
-
-        if (one_side_is_parallel(face, info, result)) {
-            return;
-        }
-
-        if (pointed_away(face, info, result)) {
-            return;
-        }
-
-        if (face_split_in_half(plane, face, info, result)) {
-            return;
-        }
+        split_face(plane, face, result);
+    }
 
-        // We've tried all of our clever edge cases, time to do a full intersection test
-        full_split(plane, face, info, result);
+    void split_face_by_plane(const AxisPlane &plane, const SlicerFace &face, SplitResult &result) {
+        split_face(plane, face, result);
     }
 }
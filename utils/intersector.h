@@ -19,17 +19,92 @@ namespace Intersector {
 
     struct SplitResult {
         Ref<Material> material;
-        PoolVector<SlicerFace> upper_faces;
-        PoolVector<SlicerFace> lower_faces;
-        PoolVector<Vector3> intersection_points;
+
+        // The ARRAY_COMPRESS_* flags the faces should be packed with when they're
+        // turned back into a surface
+        uint32_t compression;
+
+        Vector<SlicerFace> upper_faces;
+        Vector<SlicerFace> lower_faces;
+        Vector<Vector3> intersection_points;
+
+        // Which sides of the plane we actually want faces for. Faces (or the parts of faces)
+        // that land on a side that isn't being kept are dropped without ever being created
+        bool keep_upper;
+        bool keep_lower;
+
+        // When the output shares the vertex buffer of the surface it was cut from
+        // this holds that buffer, with the vertexes created by the cut appended to
+        // the end of it, and each face's source_index points into it
+        PoolVector<uint8_t> shared_vertex_array;
+        uint32_t shared_format;
+        int shared_vertex_count;
 
         void reset() {
             upper_faces.resize(0);
             lower_faces.resize(0);
             intersection_points.resize(0);
+
+            // Resizing would copy the buffer first if it's still shared with the source mesh
+            shared_vertex_array = PoolVector<uint8_t>();
+            shared_format = 0;
+            shared_vertex_count = 0;
+        }
+
+        SplitResult() {
+            compression = Mesh::ARRAY_COMPRESS_DEFAULT;
+            keep_upper = true;
+            keep_lower = true;
+            shared_format = 0;
+            shared_vertex_count = 0;
+        }
+    };
+
+    /**
+     * A plane whose normal points straight down one of the axes. A point's distance to it
+     * is just one of the point's components, so faces can be split against it without
+     * having to take any dot products
+    */
+    struct AxisPlane {
+        int axis;
+        real_t sign;
+        real_t d;
+
+        /**
+         * Checks whether the passed in plane is (within tolerance) axis aligned and, if it
+         * is, fills in r_axis_plane with the exactly aligned equivalent
+        */
+        static bool from_plane(const Plane &plane, AxisPlane &r_axis_plane) {
+            for (int i = 0; i < 3; i++) {
+                if (Math::abs(Math::abs(plane.normal[i]) - 1) <= CMP_EPSILON &&
+                    Math::abs(plane.normal[(i + 1) % 3]) <= CMP_EPSILON &&
+                    Math::abs(plane.normal[(i + 2) % 3]) <= CMP_EPSILON) {
+                    r_axis_plane.axis = i;
+                    r_axis_plane.sign = plane.normal[i] > 0 ? 1 : -1;
+                    r_axis_plane.d = plane.d;
+                    return true;
+                }
+            }
+
+            return false;
         }
 
-        SplitResult() {}
+        Plane to_plane() const {
+            Vector3 normal;
+            normal[axis] = sign;
+            return Plane(normal, d);
+        }
+
+        _FORCE_INLINE_ real_t distance_to(const Vector3 &point) const {
+            return sign * point[axis] - d;
+        }
+
+        /**
+         * How far along the plane's normal the given vector travels
+        */
+        _FORCE_INLINE_ real_t along_normal(const Vector3 &vec) const {
+            return sign * vec[axis];
+        }
     };
 
     /**
@@ -42,6 +117,11 @@ namespace Intersector {
      * the result in the result param.
     */
     void split_face_by_plane(const Plane &plane, const SlicerFace &face, SplitResult &result);
+
+    /**
+     * Same as split_face_by_plane but specialized for axis aligned planes
+    */
+    void split_face_by_plane(const AxisPlane &plane, const SlicerFace &face, SplitResult &result);
 } // Intersector
 
 
@@ -0,0 +1,118 @@
+#ifndef MESH_POOL_H
+#define MESH_POOL_H
+
+#include "../sliced_mesh.h"
+
+/**
+ * Holds on to meshes (and the SlicedMeshes that carried them) that have been handed
+ * back once they're no longer needed, so that the next cut can refill them rather
+ * than creating new resources. An ArrayMesh keeps its RID on the VisualServer for as
+ * long as it's alive, so recycling the mesh recycles the RID along with it.
+ *
+ * Nothing in here checks that a released mesh has actually stopped being used, that's
+ * up to whoever is releasing it
+*/
+struct MeshPool {
+    // How many meshes, and separately how many SlicedMeshes, can be waiting to be reused.
+    // Anything released past that is simply dropped
+    int max_size;
+
+    Vector<Ref<ArrayMesh> > meshes;
+    Vector<Ref<SlicedMesh> > sliced_meshes;
+
+    /**
+     * Hands out a mesh with no surfaces, reusing one if there's one waiting
+    */
+    Ref<ArrayMesh> take_mesh() {
+        if (meshes.size() == 0) {
+            Ref<ArrayMesh> mesh;
+            mesh.instance();
+            return mesh;
+        }
+
+        Ref<ArrayMesh> mesh = meshes[meshes.size() - 1];
+        meshes.resize(meshes.size() - 1);
+        return mesh;
+    }
+
+    /**
+     * Hands out an empty SlicedMesh, reusing one if there's one waiting
+    */
+    Ref<SlicedMesh> take_sliced_mesh() {
+        if (sliced_meshes.size() == 0) {
+            return Ref<SlicedMesh>(memnew(SlicedMesh));
+        }
+
+        Ref<SlicedMesh> sliced_mesh = sliced_meshes[sliced_meshes.size() - 1];
+        sliced_meshes.resize(sliced_meshes.size() - 1);
+        return sliced_mesh;
+    }
+
+    /**
+     * Clears out the mesh's surfaces, blend shapes and custom AABB and keeps it around for
+     * the next take_mesh. Surfaces can't be added to a mesh with blend shapes unless they
+     * bring their own, and a leftover custom AABB would cull the new surfaces with the old
+     * bounds. Only ArrayMeshes can be refilled so anything else is ignored
+    */
+    void release_mesh(const Ref<Mesh> &p_mesh) {
+        Ref<ArrayMesh> mesh = p_mesh;
+        if (mesh.is_null() || meshes.size() >= max_size) {
+            return;
+        }
+
+        ERR_FAIL_COND_MSG(meshes.find(mesh) != -1, "The mesh has already been released.");
+
+        while (mesh->get_surface_count() > 0) {
+            mesh->surface_remove(mesh->get_surface_count() - 1);
+        }
+
+        // Blend shapes can only be cleared once the surfaces are gone
+        mesh->clear_blend_shapes();
+        mesh->set_custom_aabb(AABB());
+
+        meshes.push_back(mesh);
+    }
+
+    /**
+     * Releases both halves of the SlicedMesh along with the SlicedMesh itself
+    */
+    void release(const Ref<SlicedMesh> &sliced_mesh) {
+        if (sliced_mesh.is_null() || max_size == 0) {
+            return;
+        }
+
+        ERR_FAIL_COND_MSG(sliced_meshes.find(sliced_mesh) != -1, "The sliced mesh has already been released.");
+
+        release_mesh(sliced_mesh->upper_mesh);
+        release_mesh(sliced_mesh->lower_mesh);
+        sliced_mesh->upper_mesh = Ref<Mesh>();
+        sliced_mesh->lower_mesh = Ref<Mesh>();
+
+        if (sliced_meshes.size() < max_size) {
+            sliced_meshes.push_back(sliced_mesh);
+        }
+    }
+
+    void set_max_size(int p_max_size) {
+        max_size = MAX(p_max_size, 0);
+
+        if (meshes.size() > max_size) {
+            meshes.resize(max_size);
+        }
+
+        if (sliced_meshes.size() > max_size) {
+            sliced_meshes.resize(max_size);
+        }
+    }
+
+    void clear() {
+        meshes.clear();
+        sliced_meshes.clear();
+    }
+
+    MeshPool() {
+        max_size = 0;
+    }
+};
+
+#endif // MESH_POOL_H
@@ -0,0 +1,57 @@
+#include "parallel.h"
+#include "worker_pool.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "core/vector.h"
+
+namespace Parallel {
+    struct Job {
+        Task task;
+        void *userdata;
+        int count;
+        volatile uint32_t next_idx;
+    };
+
+    void run_job(void *p_job) {
+        Job &job = *(Job *)p_job;
+
+        while (true) {
+            int idx = atomic_increment(&job.next_idx) - 1;
+            if (idx >= job.count) {
+                return;
+            }
+
+            job.task(job.userdata, idx);
+        }
+    }
+
+    void for_each(int count, int thread_count, Task task, void *userdata) {
+        // Work that's only ever going to run on this thread shouldn't start the pool up
+        WorkerPool *pool = thread_count > 1 ? WorkerPool::get_singleton() : NULL;
+        if (pool) {
+            pool->for_each(count, task, userdata);
+            return;
+        }
+
+        Job job;
+        job.task = task;
+        job.userdata = userdata;
+        job.count = count;
+        job.next_idx = 0;
+
+        // The calling thread pitches in as well, so it only needs
+        // help if there's more than one thread's worth of work
+        thread_count = MIN(thread_count, count);
+        Vector<Thread *> threads;
+        for (int i = 1; i < thread_count; i++) {
+            threads.push_back(Thread::create(run_job, &job));
+        }
+
+        run_job(&job);
+
+        for (int i = 0; i < threads.size(); i++) {
+            Thread::wait_to_finish(threads[i]);
+            memdelete(threads[i]);
+        }
+    }
+} // Parallel
@@ -0,0 +1,24 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "core/typedefs.h"
+
+/**
+ * Contains helpers for spreading work out over multiple threads
+*/
+namespace Parallel {
+    typedef void (*Task)(void *userdata, int idx);
+
+    /**
+     * Calls task once for every index from 0 up to count, spread out over up to thread_count
+     * threads (the calling thread included), and returns once they've all finished. Each
+     * thread keeps grabbing the next index nobody has started on, so tasks that take wildly
+     * different amounts of time still even out.
+     *
+     * If there's a WorkerPool running the work is handed to it instead, and thread_count
+     * only decides whether the work gets spread out at all
+    */
+    void for_each(int count, int thread_count, Task task, void *userdata);
+} // Parallel
+
+#endif // PARALLEL_H
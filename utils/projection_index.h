@@ -0,0 +1,182 @@
+#ifndef PROJECTION_INDEX_H
+#define PROJECTION_INDEX_H
+
+#include <algorithm>
+#include "intersector.h"
+
+/**
+ * Keeps the faces of a surface sorted by how far along each of a handful of
+ * directions they sit. A plane facing one of those directions can then find,
+ * with a couple of binary searches, the faces that are entirely above it, the
+ * faces that are entirely below it, and the (hopefully small) window of faces
+ * in between that actually need to be cut.
+ *
+ * This is meant for meshes that keep getting cut along the same few directions
+ * (vertical chops, a blade that only swings one way, etc). Planes that don't
+ * match any of the directions should just go through the regular path
+*/
+struct ProjectionIndex {
+    struct Axis {
+        Vector3 direction;
+
+        // Face indexes sorted by their lowest projection along the direction
+        // and the lowest and highest projection of each face in that order
+        Vector<int> order;
+        Vector<real_t> mins;
+        Vector<real_t> maxs;
+
+        // The furthest apart any one face's projections are
+        real_t max_extent;
+    };
+
+    Vector<Axis> axes;
+
+    // Distance of the furthest vertex from the origin, used to figure out how far off
+    // a projection can be when the plane is only approximately facing one of our directions
+    real_t radius;
+
+    void build(const Vector<SlicerFace> &faces, const PoolVector<Vector3> &directions) {
+        axes.clear();
+        radius = 0;
+
+        const SlicerFace *faces_reader = faces.ptr();
+        for (int i = 0; i < faces.size(); i++) {
+            for (int j = 0; j < 3; j++) {
+                radius = MAX(radius, faces_reader[i].vertex[j].length());
+            }
+        }
+
+        Vector<real_t> face_mins;
+        face_mins.resize(faces.size());
+
+        for (int i = 0; i < directions.size(); i++) {
+            Vector3 direction = directions[i].normalized();
+            if (direction == Vector3()) {
+                continue;
+            }
+
+            Axis axis;
+            axis.direction = direction;
+            axis.max_extent = 0;
+            axis.order.resize(faces.size());
+            axis.mins.resize(faces.size());
+            axis.maxs.resize(faces.size());
+
+            for (int j = 0; j < faces.size(); j++) {
+                axis.order.ptrw()[j] = j;
+                face_mins.ptrw()[j] = MIN(MIN(direction.dot(faces_reader[j].vertex[0]), direction.dot(faces_reader[j].vertex[1])), direction.dot(faces_reader[j].vertex[2]));
+            }
+
+            MinComparator comparator;
+            comparator.mins = face_mins.ptr();
+            std::sort(axis.order.ptrw(), axis.order.ptrw() + faces.size(), comparator);
+
+            for (int j = 0; j < faces.size(); j++) {
+                const SlicerFace &face = faces_reader[axis.order[j]];
+                real_t min = face_mins[axis.order[j]];
+                real_t max = MAX(MAX(direction.dot(face.vertex[0]), direction.dot(face.vertex[1])), direction.dot(face.vertex[2]));
+
+                axis.mins.ptrw()[j] = min;
+                axis.maxs.ptrw()[j] = max;
+                axis.max_extent = MAX(axis.max_extent, max - min);
+            }
+
+            axes.push_back(axis);
+        }
+    }
+
+    bool is_built() const {
+        return axes.size() > 0;
+    }
+
+    /**
+     * If the plane faces one of the indexed directions (in either sense), splits the faces
+     * and returns true. Otherwise nothing is done and the plane needs to go through the
+     * regular path. faces should be the same vector that was passed into build
+    */
+    bool split_by_plane(const Plane &plane, const Vector<SlicerFace> &faces, Intersector::SplitResult &result) const {
+        // How close (as a dot product) the plane's normal needs to be to
+        // one of our directions for us to be able to use it
+        const real_t match_tolerance = 0.0001;
+
+        for (int i = 0; i < axes.size(); i++) {
+            const Axis &axis = axes[i];
+            real_t alignment = axis.direction.dot(plane.normal);
+
+            if (ABS(alignment) < 1 - match_tolerance) {
+                continue;
+            }
+
+            // A plane facing the opposite way is the same plane with the sides swapped
+            bool flipped = alignment < 0;
+            Vector3 normal = flipped ? -plane.normal : plane.normal;
+            real_t d = flipped ? -plane.d : plane.d;
+
+            // Our projections are only exact if the plane is facing our direction exactly,
+            // so widen the window by however far they could be off
+            real_t slack = (normal - axis.direction).length() * radius;
+            real_t low = d - CMP_EPSILON - slack;
+            real_t high = d + CMP_EPSILON + slack;
+
+            Vector<SlicerFace> &above = flipped ? result.lower_faces : result.upper_faces;
+            Vector<SlicerFace> &below = flipped ? result.upper_faces : result.lower_faces;
+            bool keep_above = flipped ? result.keep_lower : result.keep_upper;
+            bool keep_below = flipped ? result.keep_upper : result.keep_lower;
+
+            // Faces starting past the top of the window are entirely above the plane, and faces
+            // starting before (the bottom of the window - the largest face) can't reach up to it
+            const real_t *mins = axis.mins.ptr();
+            int window_start = std::lower_bound(mins, mins + faces.size(), low - axis.max_extent) - mins;
+            int window_end = std::upper_bound(mins, mins + faces.size(), high) - mins;
+
+            const SlicerFace *faces_reader = faces.ptr();
+
+            if (keep_below) {
+                append_faces(below, faces_reader, axis.order.ptr(), 0, window_start);
+            }
+
+            if (keep_above) {
+                append_faces(above, faces_reader, axis.order.ptr(), window_end, faces.size());
+            }
+
+            for (int j = window_start; j < window_end; j++) {
+                if (axis.maxs[j] < low) {
+                    if (keep_below) {
+                        below.push_back(faces_reader[axis.order[j]]);
+                    }
+                } else {
+                    Intersector::split_face_by_plane(plane, faces_reader[axis.order[j]], result);
+                }
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    struct MinComparator {
+        const real_t *mins;
+
+        bool operator()(int a, int b) const {
+            return mins[a] < mins[b];
+        }
+    };
+
+    static void append_faces(Vector<SlicerFace> &dest, const SlicerFace *faces_reader, const int *order, int start, int end) {
+        if (end <= start) {
+            return;
+        }
+
+        int size = dest.size();
+        dest.resize(size + end - start);
+
+        SlicerFace *dest_writer = dest.ptrw();
+        for (int i = start; i < end; i++) {
+            dest_writer[size + i - start] = faces_reader[order[i]];
+        }
+    }
+};
+
+#endif // PROJECTION_INDEX_H
@@ -0,0 +1,102 @@
+#include "shatterer.h"
+#include "parallel.h"
+
+namespace Shatterer {
+    /**
+     * Everything the threads clipping the cells share
+    */
+    struct ShatterJob {
+        const Vector<SourceSurface> *sources;
+        const Vector<Vector3> *seeds;
+        AABB bounds;
+        Rect2 uv_rect;
+
+        // Every thread only ever writes to the cells it was handed
+        CellMesh *cells;
+    };
+
+    bool get_cell_planes(const Vector<Vector3> &seeds, int seed_idx, const AABB &bounds, Vector<Plane> &r_planes) {
+        r_planes.clear();
+
+        Vector3 seed = seeds[seed_idx];
+        Vector3 half_size = bounds.size * 0.5;
+        Vector3 center = bounds.position + half_size;
+
+        for (int i = 0; i < seeds.size(); i++) {
+            if (i == seed_idx) {
+                continue;
+            }
+
+            Vector3 other = seeds[i];
+            if (other == seed) {
+                // Only one of the two can have the space, so give it to whichever came first
+                if (i < seed_idx) {
+                    return false;
+                }
+                continue;
+            }
+
+            Vector3 normal = (other - seed).normalized();
+            Plane plane(normal, normal.dot((seed + other) * 0.5));
+
+            real_t radius = ABS(half_size.x * normal.x) + ABS(half_size.y * normal.y) + ABS(half_size.z * normal.z);
+            if (plane.distance_to(center) + radius < -CMP_EPSILON) {
+                continue;
+            }
+
+            r_planes.push_back(plane);
+        }
+
+        return true;
+    }
+
+    void shatter_cell(void *userdata, int cell_idx) {
+        ShatterJob &job = *(ShatterJob *)userdata;
+
+        Vector<Plane> planes;
+        if (!get_cell_planes(*job.seeds, cell_idx, job.bounds, planes)) {
+            return;
+        }
+
+        CellMesh outside;
+        Clipper::clip_to_convex(*job.sources, planes, false, job.cells[cell_idx], outside, job.uv_rect);
+    }
+
+    Vector<CellMesh> shatter(const Vector<SourceSurface> &sources, const Vector<Vector3> &seeds, int thread_count, Rect2 uv_rect) {
+        Vector<CellMesh> cells;
+        cells.resize(seeds.size());
+        for (int i = 0; i < cells.size(); i++) {
+            cells.ptrw()[i] = CellMesh(sources.size());
+        }
+
+        bool has_faces = false;
+        AABB bounds;
+        for (int i = 0; i < sources.size(); i++) {
+            const SlicerFace *faces_reader = sources[i].faces.ptr();
+            for (int j = 0; j < sources[i].faces.size(); j++) {
+                for (int k = 0; k < 3; k++) {
+                    if (has_faces) {
+                        bounds.expand_to(faces_reader[j].vertex[k]);
+                    } else {
+                        bounds = AABB(faces_reader[j].vertex[k], Vector3());
+                        has_faces = true;
+                    }
+                }
+            }
+        }
+
+        if (!has_faces) {
+            return cells;
+        }
+
+        ShatterJob job;
+        job.sources = &sources;
+        job.seeds = &seeds;
+        job.bounds = bounds;
+        job.uv_rect = uv_rect;
+        job.cells = cells.ptrw();
+
+        Parallel::for_each(seeds.size(), thread_count, shatter_cell, &job);
+        return cells;
+    }
+} // Shatterer
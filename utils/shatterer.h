@@ -0,0 +1,26 @@
+#ifndef SHATTERER_H
+#define SHATTERER_H
+
+#include "clipper.h"
+
+/**
+ * Contains functions for breaking a mesh apart into Voronoi cells
+*/
+namespace Shatterer {
+    /**
+     * The planes bounding the Voronoi cell of one of the seeds, which are the bisectors between
+     * it and every other seed. Bisectors that the bounds lie entirely inside of can't cut anything
+     * and are left out. Returns false if the cell is empty, which only happens to the later of
+     * two seeds that are in the same place
+    */
+    bool get_cell_planes(const Vector<Vector3> &seeds, int seed_idx, const AABB &bounds, Vector<Plane> &r_planes);
+
+    /**
+     * Splits the source surfaces up into a cell for each seed, containing the part of the mesh
+     * closer to that seed than to any other. Each cell is clipped on its own, straight from the
+     * source faces, so the cells are spread out over up to thread_count threads
+    */
+    Vector<CellMesh> shatter(const Vector<SourceSurface> &sources, const Vector<Vector3> &seeds, int thread_count, Rect2 uv_rect = Rect2(0, 0, 1, 1));
+} // Shatterer
+
+#endif // SHATTERER_H
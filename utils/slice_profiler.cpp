@@ -0,0 +1,183 @@
+#include "slice_profiler.h"
+#include "core/engine.h"
+#include "core/os/os.h"
+#include "core/script_language.h"
+
+SliceProfiler *SliceProfiler::singleton = NULL;
+
+/**
+ * The name a span goes by in the editor's profiler. Surfaces get their own entries, so that
+ * a single surface that's slow to cut stands out
+*/
+String get_frame_name(const SliceProfiler::Span &span) {
+    if (span.surface < 0) {
+        return span.name;
+    }
+    return String(span.name) + " surface " + itos(span.surface);
+}
+
+bool is_debugger_profiling() {
+    ScriptDebugger *debugger = ScriptDebugger::get_singleton();
+    return debugger && debugger->is_profiling();
+}
+
+bool SliceProfiler::is_active() const {
+    return tracing || is_debugger_profiling();
+}
+
+void SliceProfiler::add_span(const Span &span) {
+    bool send = false;
+
+    mutex->lock();
+    if (tracing) {
+        trace_spans.push_back(span);
+    }
+
+    if (is_debugger_profiling()) {
+        uint64_t current_frame = Engine::get_singleton()->get_idle_frames();
+        if (current_frame != frame) {
+            frame = current_frame;
+            frame_usec.clear();
+        }
+
+        if (span.is_stage) {
+            String frame_name = get_frame_name(span);
+            Map<String, uint64_t>::Element *total = frame_usec.find(frame_name);
+            if (total) {
+                total->value() += span.duration_usec;
+            } else {
+                frame_usec.insert(frame_name, span.duration_usec);
+            }
+        }
+
+        // The debugger isn't safe to call from other threads, but whatever spans they
+        // end get picked up the next time one ends on the main thread
+        send = Thread::get_caller_id() == Thread::get_main_id();
+    }
+    mutex->unlock();
+
+    if (send) {
+        send_frame();
+    }
+}
+
+void SliceProfiler::send_frame() {
+    Array data;
+
+    mutex->lock();
+    for (Map<String, uint64_t>::Element *E = frame_usec.front(); E; E = E->next()) {
+        data.push_back(E->key());
+        data.push_back(E->value() / 1000000.0);
+    }
+    mutex->unlock();
+
+    ScriptDebugger::get_singleton()->add_profiling_frame_data("slicer", data);
+}
+
+Error SliceProfiler::start_trace(const String &path) {
+    ERR_FAIL_COND_V_MSG(tracing, ERR_BUSY, "A trace is already running.");
+
+    Error err;
+    FileAccess *file = FileAccess::open(path, FileAccess::WRITE, &err);
+    ERR_FAIL_COND_V_MSG(!file, err, "Can't open the trace file '" + path + "'.");
+
+    mutex->lock();
+    trace_file = file;
+    trace_spans.clear();
+    tracing = true;
+    mutex->unlock();
+
+    return OK;
+}
+
+Error SliceProfiler::stop_trace() {
+    ERR_FAIL_COND_V_MSG(!tracing, ERR_UNAVAILABLE, "There's no trace running.");
+
+    mutex->lock();
+    tracing = false;
+    Vector<Span> spans = trace_spans;
+    trace_spans.clear();
+    FileAccess *file = trace_file;
+    trace_file = NULL;
+    mutex->unlock();
+
+    // Thread ids don't mean anything to anybody reading the trace, so each
+    // thread is numbered in the order it turns up, starting with the main one
+    Vector<Thread::ID> threads;
+    threads.push_back(Thread::get_main_id());
+
+    String events;
+    for (int i = 0; i < spans.size(); i++) {
+        const Span &span = spans[i];
+
+        int thread_idx = threads.find(span.thread_id);
+        if (thread_idx == -1) {
+            thread_idx = threads.size();
+            threads.push_back(span.thread_id);
+        }
+
+        String args = "\"mesh\":\"" + span.mesh_name.json_escape() + "\"";
+        if (span.surface >= 0) {
+            args += ",\"surface\":" + itos(span.surface);
+        }
+        if (span.triangles >= 0) {
+            args += ",\"triangles\":" + itos(span.triangles);
+        }
+
+        events += "{\"name\":\"" + String(span.name) + "\",\"cat\":\"slicer\",\"ph\":\"X\",\"pid\":1,\"tid\":" + itos(thread_idx) +
+            ",\"ts\":" + String::num_uint64(span.start_usec) + ",\"dur\":" + String::num_uint64(span.duration_usec) +
+            ",\"args\":{" + args + "}},\n";
+    }
+
+    for (int i = 0; i < threads.size(); i++) {
+        String thread_name = i == 0 ? String("Main thread") : "Thread " + itos(i);
+        events += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + itos(i) + ",\"args\":{\"name\":\"" + thread_name + "\"}}";
+        events += i < threads.size() - 1 ? ",\n" : "\n";
+    }
+
+    file->store_string("{\"traceEvents\":[\n" + events + "]}\n");
+    file->close();
+    memdelete(file);
+
+    return OK;
+}
+
+SliceProfiler::SliceProfiler() {
+    mutex = Mutex::create();
+    tracing = false;
+    trace_file = NULL;
+    frame = 0;
+}
+
+SliceProfiler::~SliceProfiler() {
+    if (trace_file) {
+        trace_file->close();
+        memdelete(trace_file);
+    }
+    memdelete(mutex);
+}
+
+SliceProfileScope::SliceProfileScope(const char *name, const String &mesh_name, int surface, bool is_stage) {
+    profiler = SliceProfiler::get_singleton();
+    if (!profiler || !profiler->is_active()) {
+        profiler = NULL;
+        return;
+    }
+
+    span.name = name;
+    span.mesh_name = mesh_name;
+    span.surface = surface;
+    span.triangles = -1;
+    span.is_stage = is_stage;
+    span.thread_id = Thread::get_caller_id();
+    span.start_usec = OS::get_singleton()->get_ticks_usec();
+}
+
+SliceProfileScope::~SliceProfileScope() {
+    if (!profiler) {
+        return;
+    }
+
+    span.duration_usec = OS::get_singleton()->get_ticks_usec() - span.start_usec;
+    profiler->add_span(span);
+}
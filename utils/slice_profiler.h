@@ -0,0 +1,110 @@
+#ifndef SLICE_PROFILER_H
+#define SLICE_PROFILER_H
+
+#include "core/map.h"
+#include "core/os/file_access.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+
+/**
+ * Collects how long each stage of a cut takes (parsing the mesh's surfaces, splitting them,
+ * capping the cross section and building the halves) and hands the timings on to two places.
+ * While the editor's profiler is running, they're added up over each frame and show up
+ * there in a "Slicer" category of their own. And while a trace is running (see start_trace)
+ * every span is kept, to be written out as a Chrome trace event file once it stops, which
+ * chrome://tracing or Perfetto can open.
+ *
+ * Spans can be ended from any thread. When neither of the two is running nothing is
+ * collected, and a span costs little more than checking whether they are
+*/
+class SliceProfiler {
+public:
+    struct Span {
+        const char *name;
+        String mesh_name;
+
+        // The surface the span covers, or -1 if it covers the whole mesh
+        int surface;
+        // Triangles that went into the stage, or -1 if there's no telling
+        int triangles;
+
+        // Stages are the spans that don't contain any others. Only these get passed on to the
+        // editor, which adds everything in a category together and would count the rest twice
+        bool is_stage;
+
+        uint64_t start_usec;
+        uint64_t duration_usec;
+        Thread::ID thread_id;
+    };
+
+private:
+    Mutex *mutex;
+
+    volatile bool tracing;
+    FileAccess *trace_file;
+    Vector<Span> trace_spans;
+
+    // Time spent in each stage during the frame that's being drawn, in usec
+    uint64_t frame;
+    Map<String, uint64_t> frame_usec;
+
+    static SliceProfiler *singleton;
+
+    /**
+     * Hands this frame's totals over to the editor's profiler, which replaces whatever it
+     * was handed earlier in the frame
+    */
+    void send_frame();
+
+public:
+    static SliceProfiler *get_singleton() {
+        return singleton;
+    }
+    static void set_singleton(SliceProfiler *p_singleton) {
+        singleton = p_singleton;
+    }
+
+    /**
+     * Whether anybody is listening for spans right now
+    */
+    bool is_active() const;
+
+    void add_span(const Span &span);
+
+    /**
+     * Starts keeping every span, until stop_trace writes them out to the file at path
+    */
+    Error start_trace(const String &path);
+    Error stop_trace();
+
+    bool is_tracing() const {
+        return tracing;
+    }
+
+    SliceProfiler();
+    ~SliceProfiler();
+};
+
+/**
+ * Times everything from its construction until it goes out of scope, and hands that to
+ * the SliceProfiler as a span. Does nothing if there's no profiler or nobody's listening
+*/
+class SliceProfileScope {
+    SliceProfiler *profiler;
+    SliceProfiler::Span span;
+
+public:
+    /**
+     * For counts that aren't known until the stage has run
+    */
+    void set_triangles(int triangles) {
+        span.triangles = triangles;
+    }
+
+    SliceProfileScope(const char *name, const String &mesh_name, int surface = -1, bool is_stage = true);
+    ~SliceProfileScope();
+};
+
+#endif // SLICE_PROFILER_H
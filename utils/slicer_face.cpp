@@ -14,21 +14,29 @@ void ortho_normalize(Vector3 &normal, Vector3 &tangent) {
     tangent.normalize();
 }
 
-PoolVector<SlicerFace> parse_mesh_arrays(const Mesh &mesh, int surface_idx, bool is_index_array) {
-    PoolVector<SlicerFace> faces;
-    int vert_count = is_index_array ? mesh.surface_get_array_index_len(surface_idx) : mesh.surface_get_array_len(surface_idx);
+Vector<SlicerFace> parse_arrays(const Array &arrays, int vert_count, bool is_index_array) {
+    Vector<SlicerFace> faces;
     if (vert_count == 0 || vert_count % 3 != 0) {
         return faces;
     }
 
+    PoolVector<int> indices = arrays[Mesh::ARRAY_INDEX];
+    if (is_index_array) {
+        // The arrays can come straight from a script, so an index that points past the
+        // vertexes has to be caught before the filler goes reading from it
+        PoolVector<Vector3> vertices = arrays[Mesh::ARRAY_VERTEX];
+        PoolVector<int>::Read indices_reader = indices.read();
+        for (int i = 0; i < vert_count; i++) {
+            ERR_FAIL_INDEX_V_MSG(indices_reader[i], vertices.size(), Vector<SlicerFace>(), "The index array points past the end of the vertex array.");
+        }
+    }
+
     faces.resize(vert_count / 3);
 
-    Array arrays = mesh.surface_get_arrays(surface_idx);
     FaceFiller filler(faces, arrays);
 
     if (is_index_array) {
-        PoolVector<int> indices = arrays[Mesh::ARRAY_INDEX];
-        auto indices_reader = indices.read();
+        PoolVector<int>::Read indices_reader = indices.read();
 
         for (int i = 0; i < vert_count; i++) {
             filler.fill(i, indices_reader[i]);
@@ -42,11 +50,52 @@ PoolVector<SlicerFace> parse_mesh_arrays(const Mesh &mesh, int surface_idx, bool
     return faces;
 }
 
-PoolVector<SlicerFace> SlicerFace::faces_from_surface(const Mesh &mesh, int surface_idx) {
+Vector<SlicerFace> parse_mesh_arrays(const Mesh &mesh, int surface_idx, bool is_index_array) {
+    int vert_count = is_index_array ? mesh.surface_get_array_index_len(surface_idx) : mesh.surface_get_array_len(surface_idx);
+    if (vert_count == 0 || vert_count % 3 != 0) {
+        return Vector<SlicerFace>();
+    }
+
+    Vector<SlicerFace> faces = parse_arrays(mesh.surface_get_arrays(surface_idx), vert_count, is_index_array);
+
+    // Surfaces that were written over in place (see SurfaceFiller::write_to_mesh) are padded
+    // out at the end with copies of their first vertex. Those triangles have no area and are
+    // only there to fill the old region, so they're left out. Anything else (including other
+    // triangles with no area) is parsed as it is
+    if (!is_index_array && faces.size() > 1) {
+        const SlicerFace *faces_reader = faces.ptr();
+        Vector3 first = faces_reader[0].vertex[0];
+        int kept = faces.size();
+        while (kept > 1 && faces_reader[kept - 1].vertex[0] == first && faces_reader[kept - 1].vertex[1] == first && faces_reader[kept - 1].vertex[2] == first) {
+            kept--;
+        }
+        faces.resize(kept);
+    }
+
+    return faces;
+}
+
+Vector<SlicerFace> SlicerFace::faces_from_arrays(const Array &arrays) {
+    ERR_FAIL_COND_V(arrays.size() != Mesh::ARRAY_MAX, Vector<SlicerFace>());
+    ERR_FAIL_COND_V_MSG(arrays[Mesh::ARRAY_VERTEX].get_type() != Variant::POOL_VECTOR3_ARRAY, Vector<SlicerFace>(), "The vertex array needs to be a PoolVector3Array.");
+
+    Variant::Type index_type = arrays[Mesh::ARRAY_INDEX].get_type();
+    ERR_FAIL_COND_V_MSG(index_type != Variant::NIL && index_type != Variant::POOL_INT_ARRAY, Vector<SlicerFace>(), "The index array needs to be a PoolIntArray, if there is one.");
+
+    PoolVector<int> indices = arrays[Mesh::ARRAY_INDEX];
+    if (indices.size() > 0) {
+        return parse_arrays(arrays, indices.size(), true);
+    }
+
+    PoolVector<Vector3> vertices = arrays[Mesh::ARRAY_VERTEX];
+    return parse_arrays(arrays, vertices.size(), false);
+}
+
+Vector<SlicerFace> SlicerFace::faces_from_surface(const Mesh &mesh, int surface_idx) {
     // Slicer functionality really only makes sense in the context of a mesh composed of
     // triangles
     if (mesh.surface_get_primitive_type(surface_idx) != Mesh::PRIMITIVE_TRIANGLES) {
-        return PoolVector<SlicerFace>();
+        return Vector<SlicerFace>();
     }
 
     if (mesh.surface_get_format(surface_idx) & Mesh::ARRAY_FORMAT_INDEX) {
@@ -56,6 +105,74 @@ PoolVector<SlicerFace> SlicerFace::faces_from_surface(const Mesh &mesh, int surf
     }
 }
 
+void SlicerFace::set_vertex_from(int idx, const SlicerFace &from, int from_idx) {
+    vertex[idx] = from.vertex[from_idx];
+    source_index[idx] = from.source_index[from_idx];
+
+    has_normals = from.has_normals;
+    has_tangents = from.has_tangents;
+    has_colors = from.has_colors;
+    has_bones = from.has_bones;
+    has_weights = from.has_weights;
+    has_uvs = from.has_uvs;
+    has_uv2s = from.has_uv2s;
+
+    if (has_normals)
+        normal[idx] = from.normal[from_idx];
+
+    if (has_tangents)
+        tangent[idx] = from.tangent[from_idx];
+
+    if (has_colors)
+        color[idx] = from.color[from_idx];
+
+    if (has_bones)
+        bones[idx] = from.bones[from_idx];
+
+    if (has_weights)
+        weights[idx] = from.weights[from_idx];
+
+    if (has_uvs)
+        uv[idx] = from.uv[from_idx];
+
+    if (has_uv2s)
+        uv2[idx] = from.uv2[from_idx];
+}
+
+void SlicerFace::set_vertex_between(int idx, const SlicerFace &from, int from_a, int from_b, real_t t) {
+    vertex[idx] = from.vertex[from_a] + t * (from.vertex[from_b] - from.vertex[from_a]);
+    source_index[idx] = -1;
+
+    has_normals = from.has_normals;
+    has_tangents = from.has_tangents;
+    has_colors = from.has_colors;
+    has_bones = from.has_bones;
+    has_weights = from.has_weights;
+    has_uvs = from.has_uvs;
+    has_uv2s = from.has_uv2s;
+
+    if (has_normals)
+        normal[idx] = from.normal[from_a] * (1 - t) + from.normal[from_b] * t;
+
+    if (has_tangents)
+        tangent[idx] = from.tangent[from_a] * (1 - t) + from.tangent[from_b] * t;
+
+    if (has_colors)
+        color[idx] = from.color[from_a] * (1 - t) + from.color[from_b] * t;
+
+    if (has_bones)
+        bones[idx] = from.bones[from_a] * (1 - t) + from.bones[from_b] * t;
+
+    if (has_weights)
+        weights[idx] = from.weights[from_a] * (1 - t) + from.weights[from_b] * t;
+
+    if (has_uvs)
+        uv[idx] = from.uv[from_a] * (1 - t) + from.uv[from_b] * t;
+
+    if (has_uv2s)
+        uv2[idx] = from.uv2[from_a] * (1 - t) + from.uv2[from_b] * t;
+}
+
 SlicerFace SlicerFace::sub_face(Vector3 a, Vector3 b, Vector3 c) const {
     SlicerFace new_face(a, b, c);
 
@@ -70,6 +187,16 @@ SlicerFace SlicerFace::sub_face(Vector3 a, Vector3 b, Vector3 c) const {
     // Maybe consider it a TODO
     for (int i = 0; i < 3; i++) {
         Vector3 point = new_face.vertex[i];
+
+        // Points that were carried over from this face still refer to
+        // the same vertex of the original surface
+        for (int j = 0; j < 3; j++) {
+            if (point == vertex[j]) {
+                new_face.source_index[i] = source_index[j];
+                break;
+            }
+        }
+
         Vector3 bary = barycentric_weights(point);
 
         if (has_normals) {
@@ -42,12 +42,25 @@ struct SlicerFace : public Face3 {
     bool has_uv2s;
     Vector2 uv2[3];
 
+    // The index of each vertex in the surface it was parsed from, or -1 for
+    // vertexes that were generated by a cut. This lets us point back into
+    // the original vertex buffer rather than copying the vertex out again
+    int source_index[3];
+
     /**
      * Parse a mesh's surface into a vector of faces. This will preserve the mapping
      * associated with each vertex and can handle both indexed and non indexed vertex
-     * arrays
+     * arrays. The padding SurfaceFiller::write_to_mesh leaves at the end of a surface it
+     * overwrote in place is left out
+    */
+    static Vector<SlicerFace> faces_from_surface(const Mesh &mesh, int surface_idx);
+
+    /**
+     * Same as faces_from_surface but reads the faces straight out of a set of arrays laid
+     * out like Mesh::ARRAY_*, which are assumed to describe triangles. An index array is
+     * used if there is one
     */
-    static PoolVector<SlicerFace> faces_from_surface(const Mesh &mesh, int surface_idx);
+    static Vector<SlicerFace> faces_from_arrays(const Array &arrays);
 
     /**
      * Creates a new face while using barycentric weights to interpolate UV, normal, etc
@@ -55,6 +68,18 @@ struct SlicerFace : public Face3 {
      */
     SlicerFace sub_face(Vector3 a, Vector3 b, Vector3 c) const;
 
+    /**
+     * Copies a vertex, along with all of its data, from another face into this one
+    */
+    void set_vertex_from(int idx, const SlicerFace &from, int from_idx);
+
+    /**
+     * Sets a vertex to the point t of the way along the edge between two of another face's
+     * vertexes, interpolating all of the data along with it. The new vertex doesn't exist in
+     * the surface the other face was parsed from so it has no source_index
+    */
+    void set_vertex_between(int idx, const SlicerFace &from, int from_a, int from_b, real_t t);
+
     /**
      * Uses normal and UV information to generate tangents for each point in the face
     */
@@ -127,6 +152,8 @@ struct SlicerFace : public Face3 {
       has_colors = false;
       has_bones = false;
       has_weights = false;
+
+      source_index[0] = source_index[1] = source_index[2] = -1;
     }
     SlicerFace(const Vector3 &a, const Vector3 &b, const Vector3 &c) {
       vertex[0] = a;
@@ -140,6 +167,8 @@ struct SlicerFace : public Face3 {
       has_colors = false;
       has_bones = false;
       has_weights = false;
+
+      source_index[0] = source_index[1] = source_index[2] = -1;
     }
 };
 
@@ -2,11 +2,17 @@
 #define SURFACE_FILLER_H
 
 #include "slicer_face.h"
+#include "servers/visual_server.h"
 
 /**
  * The inverse of FaceFiller, this struct is responsible for taking
- * SlicerFaces and serializing them back into vertex arrays for Godot
- * to read into a mesh surface
+ * SlicerFaces and serializing them back into a vertex buffer for Godot
+ * to read into a mesh surface.
+ *
+ * Rather than handing Godot a set of vertex arrays (which it would then
+ * have to validate, rescan for an AABB, and repack) we write the final
+ * interleaved bytes ourselves, in the same layout the VisualServer would
+ * have produced, and pass them along with the AABB we built up while filling.
 */
 struct SurfaceFiller {
     bool has_normals;
@@ -17,35 +23,86 @@ struct SurfaceFiller {
     bool has_uvs;
     bool has_uv2s;
 
-    PoolVector<SlicerFace>::Read faces_reader;
+    // Holding on to the faces keeps faces_reader valid for as long as we need it
+    Vector<SlicerFace> faces;
+    const SlicerFace *faces_reader;
 
-    Array arrays;
-    PoolVector<Vector3> vertexes;
-    PoolVector<Vector3>::Write vertexes_writer;
+    // The VisualServer format (array and compression flags) of our vertex buffer
+    // and where each array lives inside of a single vertex
+    uint32_t format;
+    uint32_t stride;
+    uint32_t offsets[Mesh::ARRAY_MAX];
 
-    PoolVector<Vector3> normals;
-    PoolVector<Vector3>::Write normals_writer;
+    int vertex_count;
+    PoolVector<uint8_t> vertex_array;
+    PoolVector<uint8_t>::Write vertex_writer;
 
-    PoolVector<real_t> tangents;
-    PoolVector<real_t>::Write tangents_writer;
+    // Only used when faces are attached to the vertex buffer by index
+    // rather than having every corner packed out in order
+    int index_count;
+    int index_size;
+    PoolVector<uint8_t> index_array;
+    PoolVector<uint8_t>::Write index_writer;
 
-    PoolVector<Color> colors;
-    PoolVector<Color>::Write colors_writer;
+    bool has_aabb;
+    AABB aabb;
+    Vector<AABB> bone_aabbs;
 
-    PoolVector<real_t> bones;
-    PoolVector<real_t>::Write bones_writer;
-
-    PoolVector<real_t> weights;
-    PoolVector<real_t>::Write weights_writer;
-
-    PoolVector<Vector2> uvs;
-    PoolVector<Vector2>::Write uvs_writer;
+    /**
+     * Calculates the offset of each array inside of a vertex for the given format
+     * and returns the size of the vertex as a whole. This mirrors the packing done
+     * by VisualServer::mesh_add_surface_from_arrays
+    */
+    static uint32_t make_offsets_from_format(uint32_t p_format, uint32_t *r_offsets) {
+        uint32_t total_size = 0;
+
+        for (int i = 0; i < Mesh::ARRAY_MAX; i++) {
+            r_offsets[i] = 0;
+
+            if (!(p_format & (1 << i)) || i == Mesh::ARRAY_INDEX) {
+                continue;
+            }
+
+            uint32_t elem_size = 0;
+            switch (i) {
+                case Mesh::ARRAY_VERTEX:
+                    // Compressed vertexes get padded out to 4 half floats
+                    elem_size = (p_format & Mesh::ARRAY_COMPRESS_VERTEX) ? sizeof(uint16_t) * 4 : sizeof(float) * 3;
+                    break;
+                case Mesh::ARRAY_NORMAL:
+                    elem_size = (p_format & Mesh::ARRAY_COMPRESS_NORMAL) ? sizeof(uint32_t) : sizeof(float) * 3;
+                    break;
+                case Mesh::ARRAY_TANGENT:
+                    elem_size = (p_format & Mesh::ARRAY_COMPRESS_TANGENT) ? sizeof(uint32_t) : sizeof(float) * 4;
+                    break;
+                case Mesh::ARRAY_COLOR:
+                    elem_size = (p_format & Mesh::ARRAY_COMPRESS_COLOR) ? sizeof(uint32_t) : sizeof(float) * 4;
+                    break;
+                case Mesh::ARRAY_TEX_UV:
+                    elem_size = (p_format & Mesh::ARRAY_COMPRESS_TEX_UV) ? sizeof(uint32_t) : sizeof(float) * 2;
+                    break;
+                case Mesh::ARRAY_TEX_UV2:
+                    elem_size = (p_format & Mesh::ARRAY_COMPRESS_TEX_UV2) ? sizeof(uint32_t) : sizeof(float) * 2;
+                    break;
+                case Mesh::ARRAY_BONES:
+                    elem_size = (p_format & Mesh::ARRAY_FLAG_USE_16_BIT_BONES) ? sizeof(uint16_t) * 4 : sizeof(uint32_t);
+                    break;
+                case Mesh::ARRAY_WEIGHTS:
+                    elem_size = (p_format & Mesh::ARRAY_COMPRESS_WEIGHTS) ? sizeof(uint16_t) * 4 : sizeof(float) * 4;
+                    break;
+            }
+
+            r_offsets[i] = total_size;
+            total_size += elem_size;
+        }
 
-    PoolVector<Vector2> uv2s;
-    PoolVector<Vector2>::Write uv2s_writer;
+        return total_size;
+    }
 
-    SurfaceFiller(const PoolVector<SlicerFace> &faces) {
-        SlicerFace first_face = faces[0];
+    SurfaceFiller(const Vector<SlicerFace> &p_faces, uint32_t compression = Mesh::ARRAY_COMPRESS_DEFAULT) {
+        faces = p_faces;
+        faces_reader = faces.ptr();
+        const SlicerFace &first_face = faces_reader[0];
 
         has_normals = first_face.has_normals;
         has_tangents = first_face.has_tangents;
@@ -55,54 +112,114 @@ struct SurfaceFiller {
         has_uvs = first_face.has_uvs;
         has_uv2s = first_face.has_uv2s;
 
-        faces_reader = faces.read();
+        format = Mesh::ARRAY_FORMAT_VERTEX | compression;
+        format &= ~(Mesh::ARRAY_FORMAT_INDEX | Mesh::ARRAY_FLAG_USE_2D_VERTICES | Mesh::ARRAY_FLAG_USE_16_BIT_BONES);
 
-        arrays.resize(Mesh::ARRAY_MAX);
+        // There's gotta be a less tedious way of doing this
+        if (has_normals)
+            format |= Mesh::ARRAY_FORMAT_NORMAL;
 
-        int array_length = faces.size() * 3;
-        vertexes.resize(array_length);
-        vertexes_writer = vertexes.write();
+        if (has_tangents)
+            format |= Mesh::ARRAY_FORMAT_TANGENT;
 
-        // There's gotta be a less tedious way of doing this
-        if (has_normals) {
-            normals.resize(array_length);
-            normals_writer = normals.write();
-        }
+        if (has_colors)
+            format |= Mesh::ARRAY_FORMAT_COLOR;
 
-        if (has_tangents) {
-            tangents.resize(array_length * 4);
-            tangents_writer = tangents.write();
-        }
+        if (has_bones)
+            format |= Mesh::ARRAY_FORMAT_BONES;
 
-        if (has_colors) {
-            colors.resize(array_length);
-            colors_writer = colors.write();
-        }
+        if (has_weights)
+            format |= Mesh::ARRAY_FORMAT_WEIGHTS;
+
+        if (has_uvs)
+            format |= Mesh::ARRAY_FORMAT_TEX_UV;
+
+        if (has_uv2s)
+            format |= Mesh::ARRAY_FORMAT_TEX_UV2;
 
         if (has_bones) {
-            bones.resize(array_length * 4);
-            bones_writer = bones.write();
+            // Bones are packed into bytes unless there's an index that wouldn't fit,
+            // in which case the whole surface needs to use shorts
+            int max_bone = 0;
+            for (int i = 0; i < faces.size(); i++) {
+                for (int j = 0; j < 3; j++) {
+                    for (int k = 0; k < 4; k++) {
+                        max_bone = MAX(max_bone, (int)faces_reader[i].bones[j][k]);
+                    }
+                }
+            }
+
+            if (max_bone > 255) {
+                format |= Mesh::ARRAY_FLAG_USE_16_BIT_BONES;
+            }
         }
 
-        if (has_weights) {
-            weights.resize(array_length * 4);
-            weights_writer = weights.write();
-        }
+        stride = make_offsets_from_format(format, offsets);
 
-        if (has_uvs) {
-            uvs.resize(array_length);
-            uvs_writer = uvs.write();
-        }
+        vertex_count = 0;
+        resize_vertexes(faces.size() * 3);
 
-        if (has_uv2s) {
-            uv2s.resize(array_length);
-            uv2s_writer = uv2s.write();
-        }
+        index_count = 0;
+        index_size = 0;
+        has_aabb = false;
+    }
+
+    /**
+     * Sets up a filler around a vertex buffer that has already been packed in the
+     * given format, such as the buffer of the surface that is being cut. Faces are
+     * attached to it through an index buffer (see set_index) and any new vertexes can
+     * be appended using resize_vertexes and fill_vertex. The passed in buffer is shared
+     * rather than copied for as long as nothing is appended to it
+    */
+    SurfaceFiller(uint32_t p_format, const PoolVector<uint8_t> &p_vertex_array, int p_vertex_count, int p_index_count) {
+        format = p_format & ~Mesh::ARRAY_FORMAT_INDEX;
+        faces_reader = NULL;
+
+        has_normals = format & Mesh::ARRAY_FORMAT_NORMAL;
+        has_tangents = format & Mesh::ARRAY_FORMAT_TANGENT;
+        has_colors = format & Mesh::ARRAY_FORMAT_COLOR;
+        has_bones = format & Mesh::ARRAY_FORMAT_BONES;
+        has_weights = format & Mesh::ARRAY_FORMAT_WEIGHTS;
+        has_uvs = format & Mesh::ARRAY_FORMAT_TEX_UV;
+        has_uv2s = format & Mesh::ARRAY_FORMAT_TEX_UV2;
+
+        stride = make_offsets_from_format(format, offsets);
+
+        vertex_count = p_vertex_count;
+        vertex_array = p_vertex_array;
+
+        index_count = 0;
+        index_size = 0;
+        has_aabb = false;
+
+        resize_indexes(p_index_count);
+    }
+
+    /**
+     * Grows (or shrinks) the vertex buffer while keeping the vertexes already in it
+    */
+    void resize_vertexes(int p_vertex_count) {
+        vertex_writer.release();
+        vertex_count = p_vertex_count;
+        vertex_array.resize(vertex_count * stride);
+        vertex_writer = vertex_array.write();
+    }
+
+    /**
+     * Allocates an index buffer. Godot picks the width of the indexes based on the amount of
+     * vertexes in the surface, so this needs to be called once the vertex count is known
+    */
+    void resize_indexes(int p_index_count) {
+        index_writer.release();
+        index_count = p_index_count;
+        index_size = vertex_count >= (1 << 16) ? sizeof(uint32_t) : sizeof(uint16_t);
+        index_array.resize(index_count * index_size);
+        index_writer = index_array.write();
     }
 
     /**
-     * Takes data from the faces using the lookup_idx and stores it
-     * to be saved into vertex arrays (see add_to_mesh for how to attach
+     * Takes data from the faces using the lookup_idx and packs it into
+     * the vertex buffer at set_idx (see add_to_mesh for how to attach
      * that information into a mesh)
     */
     _FORCE_INLINE_ void fill(int lookup_idx, int set_idx) {
@@ -118,104 +235,247 @@ struct SurfaceFiller {
         int face_idx = lookup_idx / 3;
         int idx_offset = lookup_idx % 3;
 
-        SlicerFace face = faces_reader[face_idx];
+        fill_vertex(faces_reader[face_idx], idx_offset, set_idx);
+    }
 
-        vertexes_writer[set_idx] = face.vertex[idx_offset];
+    /**
+     * Packs the given corner of a face into the vertex buffer at set_idx
+    */
+    _FORCE_INLINE_ void fill_vertex(const SlicerFace &face, int idx_offset, int set_idx) {
+        uint8_t *vertex = vertex_writer.ptr() + set_idx * stride;
+
+        Vector3 point = face.vertex[idx_offset];
+        track(face, idx_offset);
+
+        if (format & Mesh::ARRAY_COMPRESS_VERTEX) {
+            uint16_t data[4] = {
+                Math::make_half_float(point.x),
+                Math::make_half_float(point.y),
+                Math::make_half_float(point.z),
+                Math::make_half_float(1.0)
+            };
+            copymem(vertex + offsets[Mesh::ARRAY_VERTEX], data, sizeof(data));
+        } else {
+            float data[3] = { (float)point.x, (float)point.y, (float)point.z };
+            copymem(vertex + offsets[Mesh::ARRAY_VERTEX], data, sizeof(data));
+        }
 
         if (has_normals) {
-            normals_writer[set_idx] = face.normal[idx_offset];
+            Vector3 normal = face.normal[idx_offset];
+            if (format & Mesh::ARRAY_COMPRESS_NORMAL) {
+                int8_t data[4] = {
+                    (int8_t)CLAMP(normal.x * 127, -128, 127),
+                    (int8_t)CLAMP(normal.y * 127, -128, 127),
+                    (int8_t)CLAMP(normal.z * 127, -128, 127),
+                    0
+                };
+                copymem(vertex + offsets[Mesh::ARRAY_NORMAL], data, sizeof(data));
+            } else {
+                float data[3] = { (float)normal.x, (float)normal.y, (float)normal.z };
+                copymem(vertex + offsets[Mesh::ARRAY_NORMAL], data, sizeof(data));
+            }
         }
 
         if (has_tangents) {
-            tangents_writer[set_idx * 4] = face.tangent[idx_offset][0];
-            tangents_writer[set_idx * 4 + 1] = face.tangent[idx_offset][1];
-            tangents_writer[set_idx * 4 + 2] = face.tangent[idx_offset][2];
-            tangents_writer[set_idx * 4 + 3] = face.tangent[idx_offset][3];
+            const SlicerVector4 &tangent = face.tangent[idx_offset];
+            if (format & Mesh::ARRAY_COMPRESS_TANGENT) {
+                int8_t data[4];
+                for (int i = 0; i < 4; i++) {
+                    data[i] = (int8_t)CLAMP(tangent[i] * 127, -128, 127);
+                }
+                copymem(vertex + offsets[Mesh::ARRAY_TANGENT], data, sizeof(data));
+            } else {
+                float data[4] = { (float)tangent.x, (float)tangent.y, (float)tangent.z, (float)tangent.w };
+                copymem(vertex + offsets[Mesh::ARRAY_TANGENT], data, sizeof(data));
+            }
         }
 
         if (has_colors) {
-            colors_writer[set_idx] = face.color[idx_offset];
+            const Color &color = face.color[idx_offset];
+            if (format & Mesh::ARRAY_COMPRESS_COLOR) {
+                uint8_t data[4];
+                for (int i = 0; i < 4; i++) {
+                    data[i] = CLAMP(int(color[i] * 255.0), 0, 255);
+                }
+                copymem(vertex + offsets[Mesh::ARRAY_COLOR], data, sizeof(data));
+            } else {
+                copymem(vertex + offsets[Mesh::ARRAY_COLOR], color.components, sizeof(float) * 4);
+            }
+        }
+
+        if (has_uvs) {
+            pack_uv(vertex + offsets[Mesh::ARRAY_TEX_UV], face.uv[idx_offset], format & Mesh::ARRAY_COMPRESS_TEX_UV);
+        }
+
+        if (has_uv2s) {
+            pack_uv(vertex + offsets[Mesh::ARRAY_TEX_UV2], face.uv2[idx_offset], format & Mesh::ARRAY_COMPRESS_TEX_UV2);
         }
 
         if (has_bones) {
-            bones_writer[set_idx * 4] = face.bones[idx_offset][0];
-            bones_writer[set_idx * 4 + 1] = face.bones[idx_offset][1];
-            bones_writer[set_idx * 4 + 2] = face.bones[idx_offset][2];
-            bones_writer[set_idx * 4 + 3] = face.bones[idx_offset][3];
+            const SlicerVector4 &bones = face.bones[idx_offset];
+            if (format & Mesh::ARRAY_FLAG_USE_16_BIT_BONES) {
+                uint16_t data[4];
+                for (int i = 0; i < 4; i++) {
+                    data[i] = (uint16_t)bones[i];
+                }
+                copymem(vertex + offsets[Mesh::ARRAY_BONES], data, sizeof(data));
+            } else {
+                uint8_t data[4];
+                for (int i = 0; i < 4; i++) {
+                    data[i] = (uint8_t)bones[i];
+                }
+                copymem(vertex + offsets[Mesh::ARRAY_BONES], data, sizeof(data));
+            }
         }
 
         if (has_weights) {
-            weights_writer[set_idx * 4] = face.weights[idx_offset][0];
-            weights_writer[set_idx * 4 + 1] = face.weights[idx_offset][1];
-            weights_writer[set_idx * 4 + 2] = face.weights[idx_offset][2];
-            weights_writer[set_idx * 4 + 3] = face.weights[idx_offset][3];
+            const SlicerVector4 &weights = face.weights[idx_offset];
+            if (format & Mesh::ARRAY_COMPRESS_WEIGHTS) {
+                uint16_t data[4];
+                for (int i = 0; i < 4; i++) {
+                    data[i] = CLAMP(weights[i] * 65535, 0, 65535);
+                }
+                copymem(vertex + offsets[Mesh::ARRAY_WEIGHTS], data, sizeof(data));
+            } else {
+                float data[4] = { (float)weights.x, (float)weights.y, (float)weights.z, (float)weights.w };
+                copymem(vertex + offsets[Mesh::ARRAY_WEIGHTS], data, sizeof(data));
+            }
         }
 
-        if (has_uvs) {
-            uvs_writer[set_idx] = face.uv[idx_offset];
+    }
+
+    /**
+     * Points the index at set_idx to the vertex at vertex_idx
+    */
+    _FORCE_INLINE_ void set_index(int set_idx, int vertex_idx) {
+        if (index_size == sizeof(uint32_t)) {
+            ((uint32_t *)index_writer.ptr())[set_idx] = vertex_idx;
+        } else {
+            ((uint16_t *)index_writer.ptr())[set_idx] = vertex_idx;
         }
+    }
 
-        if (has_uv2s) {
-            uv2s_writer[set_idx] = face.uv2[idx_offset];
+    /**
+     * Grows the surface's AABB (and bone AABBs) to include the given corner of a face.
+     * fill_vertex does this on its own, so this only needs to be called for vertexes
+     * that were packed by someone else and are being referenced by index
+    */
+    _FORCE_INLINE_ void track(const SlicerFace &face, int idx_offset) {
+        Vector3 point = face.vertex[idx_offset];
+        if (has_aabb) {
+            aabb.expand_to(point);
+        } else {
+            aabb = AABB(point, Vector3());
+            has_aabb = true;
+        }
+
+        if (has_bones && has_weights) {
+            // Skinned meshes are culled using the AABB of each bone rather than of the
+            // surface as a whole, so we need to keep track of those as well
+            for (int i = 0; i < 4; i++) {
+                if (face.weights[idx_offset][i] == 0) {
+                    continue;
+                }
+
+                int bone = (int)face.bones[idx_offset][i];
+                if (bone >= bone_aabbs.size()) {
+                    int prev_size = bone_aabbs.size();
+                    bone_aabbs.resize(bone + 1);
+                    for (int j = prev_size; j < bone_aabbs.size(); j++) {
+                        // A negative size marks the bone as unused
+                        bone_aabbs.ptrw()[j].size = Vector3(-1, -1, -1);
+                    }
+                }
+
+                AABB &bone_aabb = bone_aabbs.ptrw()[bone];
+                if (bone_aabb.size.x < 0) {
+                    bone_aabb = AABB(point, Vector3());
+                } else {
+                    bone_aabb.expand_to(point);
+                }
+            }
+        }
+    }
+
+    /**
+     * Finishes writing to the vertex buffer and returns it so that it can be shared
+     * with other surfaces
+    */
+    PoolVector<uint8_t> get_vertex_array() {
+        vertex_writer.release();
+        return vertex_array;
+    }
+
+    _FORCE_INLINE_ static void pack_uv(uint8_t *dest, const Vector2 &uv, bool compressed) {
+        if (compressed) {
+            uint16_t data[2] = { Math::make_half_float(uv.x), Math::make_half_float(uv.y) };
+            copymem(dest, data, sizeof(data));
+        } else {
+            float data[2] = { (float)uv.x, (float)uv.y };
+            copymem(dest, data, sizeof(data));
         }
     }
 
     /**
-     * Adds the vertex information read from the "fill" as a new surface
+     * Adds the vertex buffer packed by "fill" as a new surface
      * of the passed in mesh and sets the passed in material to the new
      * surface
     */
     void add_to_mesh(ArrayMesh &mesh, Ref<Material> material) {
-        arrays[Mesh::ARRAY_VERTEX] = vertexes;
-
-        if (has_normals)
-            arrays[Mesh::ARRAY_NORMAL] = normals;
-        
-        if (has_tangents)
-            arrays[Mesh::ARRAY_TANGENT] = tangents;
-
-        if (has_colors)
-            arrays[Mesh::ARRAY_COLOR] = colors;
-
-        if (has_bones)
-            arrays[Mesh::ARRAY_BONES] = bones;
-        
-        if (has_weights)
-            arrays[Mesh::ARRAY_WEIGHTS] = weights;
-        
-        if (has_uvs)
-            arrays[Mesh::ARRAY_TEX_UV] = uvs;
+        write_to_mesh(mesh, mesh.get_surface_count(), material);
+    }
 
-        if (has_uv2s)
-            arrays[Mesh::ARRAY_TEX_UV2] = uv2s;
+    /**
+     * Like add_to_mesh but puts the surface at surface_idx, which can be at most the mesh's
+     * surface count. If the surface already there has the same layout, and is at least as
+     * large as the new one, its vertexes are overwritten with surface_update_region, and
+     * whatever's left of it past the new vertexes is collapsed into triangles with no area.
+     * The surface keeps its old vertex count in that case. Otherwise it (along with every
+     * surface after it) is removed and the new one appended
+    */
+    void write_to_mesh(ArrayMesh &mesh, int surface_idx, Ref<Material> material) {
+        vertex_writer.release();
+        index_writer.release();
+
+        uint32_t surface_format = index_count > 0 ? format | Mesh::ARRAY_FORMAT_INDEX : format;
+
+        if (surface_idx < mesh.get_surface_count()) {
+            // The surface's AABB can't be updated along with its vertexes, but a stale AABB
+            // that's larger than it needs to be only costs a little culling precision
+            if (index_count == 0 && !has_bones &&
+                mesh.surface_get_primitive_type(surface_idx) == Mesh::PRIMITIVE_TRIANGLES &&
+                mesh.surface_get_format(surface_idx) == surface_format &&
+                vertex_count > 0 && mesh.surface_get_array_len(surface_idx) >= vertex_count &&
+                VisualServer::get_singleton()->mesh_surface_get_aabb(mesh.get_rid(), surface_idx).encloses(aabb)) {
+                int region_len = mesh.surface_get_array_len(surface_idx);
+                PoolVector<uint8_t> region = vertex_array;
+                if (region_len > vertex_count) {
+                    // Every leftover vertex becomes a copy of our first, so the old triangles
+                    // past the end of ours have no area and never get drawn
+                    region.resize(region_len * stride);
+                    PoolVector<uint8_t>::Write region_writer = region.write();
+                    for (int i = vertex_count; i < region_len; i++) {
+                        copymem(region_writer.ptr() + i * stride, region_writer.ptr(), stride);
+                    }
+                }
+
+                mesh.surface_update_region(surface_idx, 0, region);
+                mesh.surface_set_material(surface_idx, material);
+                return;
+            }
+
+            while (mesh.get_surface_count() > surface_idx) {
+                mesh.surface_remove(mesh.get_surface_count() - 1);
+            }
+        }
 
-        mesh.add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+        mesh.add_surface(surface_format, Mesh::PRIMITIVE_TRIANGLES, vertex_array, vertex_count, index_array, index_count, aabb, Vector<PoolVector<uint8_t> >(), bone_aabbs);
         mesh.surface_set_material(mesh.get_surface_count() - 1, material);
     }
 
     ~SurfaceFiller() {
-        vertexes_writer.release();
-
-        if (has_normals)
-            normals_writer.release();
-
-        if (has_tangents)
-            tangents_writer.release();
-        
-        if (has_colors)
-            colors_writer.release();
-        
-        if (has_bones)
-            bones_writer.release();
-        
-        if (has_weights)
-            weights_writer.release();
-
-        if (has_uvs)
-            uvs_writer.release();
-        
-        if (has_uv2s)
-            uv2s_writer.release();
+        vertex_writer.release();
+        index_writer.release();
     }
 };
 
@@ -0,0 +1,104 @@
+#include "task_graph.h"
+#include "core/safe_refcount.h"
+
+int TaskGraph::add_task(Task task, void *userdata, int idx) {
+    Node node;
+    node.task = task;
+    node.userdata = userdata;
+    node.idx = idx;
+    node.waiting_on = 0;
+    nodes.push_back(node);
+    return nodes.size() - 1;
+}
+
+void TaskGraph::add_dependency(int task, int dependency) {
+    ERR_FAIL_INDEX(task, nodes.size());
+    ERR_FAIL_INDEX(dependency, nodes.size());
+
+    Node *nodes_writer = nodes.ptrw();
+    nodes_writer[task].waiting_on++;
+    nodes_writer[dependency].dependents.push_back(task);
+}
+
+bool TaskGraph::is_acyclic() const {
+    Vector<int> waiting_on;
+    Vector<int> ready;
+    waiting_on.resize(nodes.size());
+    for (int i = 0; i < nodes.size(); i++) {
+        waiting_on.ptrw()[i] = nodes[i].waiting_on;
+        if (nodes[i].waiting_on == 0) {
+            ready.push_back(i);
+        }
+    }
+
+    for (int i = 0; i < ready.size(); i++) {
+        const Vector<int> &dependents = nodes[ready[i]].dependents;
+        for (int j = 0; j < dependents.size(); j++) {
+            if (--waiting_on.ptrw()[dependents[j]] == 0) {
+                ready.push_back(dependents[j]);
+            }
+        }
+    }
+
+    return ready.size() == nodes.size();
+}
+
+void TaskGraph::run_node(void *p_graph, int node_idx) {
+    TaskGraph *graph = (TaskGraph *)p_graph;
+    Node &node = graph->running_nodes[node_idx];
+    node.task(node.userdata, node.idx);
+
+    for (int i = 0; i < node.dependents.size(); i++) {
+        int dependent = node.dependents[i];
+        if (atomic_decrement(&graph->running_nodes[dependent].waiting_on) == 0) {
+            graph->pool->queue_chunk(graph->batch, dependent, dependent + 1);
+        }
+    }
+}
+
+void TaskGraph::run() {
+    ERR_FAIL_COND_MSG(!is_acyclic(), "The tasks can't depend on each other in a loop.");
+
+    pool = WorkerPool::get_singleton();
+    if (!pool) {
+        // Same order is_acyclic goes through them in
+        Vector<int> ready;
+        for (int i = 0; i < nodes.size(); i++) {
+            if (nodes[i].waiting_on == 0) {
+                ready.push_back(i);
+            }
+        }
+
+        Node *nodes_writer = nodes.ptrw();
+        for (int i = 0; i < ready.size(); i++) {
+            Node &node = nodes_writer[ready[i]];
+            node.task(node.userdata, node.idx);
+
+            for (int j = 0; j < node.dependents.size(); j++) {
+                if (--nodes_writer[node.dependents[j]].waiting_on == 0) {
+                    ready.push_back(node.dependents[j]);
+                }
+            }
+        }
+        return;
+    }
+
+    // Every task has to be looked at before any of them start, otherwise one that a
+    // finished task just freed up would look ready here too and be queued twice
+    Vector<int> ready;
+    for (int i = 0; i < nodes.size(); i++) {
+        if (nodes[i].waiting_on == 0) {
+            ready.push_back(i);
+        }
+    }
+
+    running_nodes = nodes.ptrw();
+    batch = pool->begin_batch(run_node, this, nodes.size());
+    for (int i = 0; i < ready.size(); i++) {
+        pool->queue_chunk(batch, ready[i], ready[i] + 1);
+    }
+    pool->finish_batch(batch);
+
+    running_nodes = NULL;
+    batch = NULL;
+}
@@ -0,0 +1,72 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include "core/vector.h"
+#include "worker_pool.h"
+
+/**
+ * A handful of tasks, some of which can't start until others have finished. Running the
+ * graph hands each task to the WorkerPool as soon as everything it depends on is done, so
+ * tasks that don't depend on each other overlap. Without a pool, the tasks run one after
+ * another on the calling thread, in the order they were added as far as their dependencies
+ * allow.
+ *
+ * A graph can only be run once
+*/
+class TaskGraph {
+public:
+    typedef void (*Task)(void *userdata, int idx);
+
+private:
+    struct Node {
+        Task task;
+        void *userdata;
+        int idx;
+
+        // How many of the tasks this one depends on haven't finished yet
+        volatile uint32_t waiting_on;
+        Vector<int> dependents;
+    };
+
+    Vector<Node> nodes;
+
+    // Only set while the graph is running on a pool
+    Node *running_nodes;
+    WorkerPool *pool;
+    WorkerPool::Batch *batch;
+
+    static void run_node(void *p_graph, int node_idx);
+
+    /**
+     * Whether every task can be reached without going round in circles
+    */
+    bool is_acyclic() const;
+
+public:
+    /**
+     * Adds a task that calls task(userdata, idx), returning its id
+    */
+    int add_task(Task task, void *userdata, int idx = 0);
+
+    /**
+     * Holds the task back until dependency has finished
+    */
+    void add_dependency(int task, int dependency);
+
+    int get_task_count() const {
+        return nodes.size();
+    }
+
+    /**
+     * Runs every task, returning once they've all finished
+    */
+    void run();
+
+    TaskGraph() {
+        running_nodes = NULL;
+        pool = NULL;
+        batch = NULL;
+    }
+};
+
+#endif // TASK_GRAPH_H
@@ -18,6 +18,11 @@ struct Mapped2D {
         mapped = Vector2(newOriginal.dot(u), newOriginal.dot(v));
     }
 
+    Mapped2D(Vector3 newOriginal, Vector2 newMapped) {
+        original = newOriginal;
+        mapped = newMapped;
+    }
+
     struct Comparator {
         _FORCE_INLINE_ bool operator()(const Mapped2D &a, const Mapped2D &b) const {
             Vector2 x = a.mapped;
@@ -32,36 +37,84 @@ struct Mapped2D {
     };
 };
 
+/**
+ * When the plane normal lies along an axis, the u and v vectors monotone_chain builds are
+ * always axes themselves (these are exactly what its cross products work out to). Mapping
+ * a point then just means picking out two of its components, so we skip building the basis
+ * and taking dot products altogether
+ */
+struct AxisMapping {
+    int u_axis;
+    real_t u_sign;
+    int v_axis;
+    real_t v_sign;
+};
+
+// Indexed by [axis of the normal][0 if it's pointing in the positive direction, 1 otherwise]
+static const AxisMapping AXIS_MAPPINGS[3][2] = {
+    { { 2, 1, 1, 1 }, { 2, -1, 1, 1 } },
+    { { 0, -1, 2, -1 }, { 0, 1, 2, -1 } },
+    { { 0, -1, 1, 1 }, { 0, 1, 1, 1 } },
+};
+
+/**
+ * Returns the axis the passed in normal lies exactly along, or -1
+ */
+int get_normal_axis(const Vector3 &normal) {
+    for (int i = 0; i < 3; i++) {
+        if (Math::abs(normal[i]) == 1 && normal[(i + 1) % 3] == 0 && normal[(i + 2) % 3] == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
 namespace Triangulator {
     real_t tri_area_2d(real_t x1, real_t y1, real_t x2, real_t y2, real_t x3, real_t y3) {
         return (x1 - x2) * (y2 - y3) - (x2 - x3) * (y1 - y2);
     }
     
+    void plane_basis(const Vector3 &plane_normal, Vector3 &r_u, Vector3 &r_v) {
+        r_u = plane_normal.cross(Vector3(0, 1, 0)).normalized();
+        if (r_u == Vector3(0, 0, 0)) {
+            r_u = plane_normal.cross(Vector3(0, 0, -1)).normalized();
+        }
+        r_v = r_u.cross(plane_normal);
+    }
+
     // Godot has a QuickHull function (along with VHACD bindings which I'm sure has all kind of crazy smart stuff in it)
     // But as this is primarily a learning exercise (and because monotone chain has a slightly different time complexity
     // and our need to support uv mappings and such) let's try to implement this ourselves (or, more accurately, copy
     // it over from Ezy-Slice)
-    PoolVector<SlicerFace> monotone_chain(const PoolVector<Vector3> &interception_points, Vector3 plane_normal) {
+    Vector<SlicerFace> monotone_chain(const Vector<Vector3> &interception_points, Vector3 plane_normal, Rect2 uv_rect) {
         // We'll be using the monotone_chain algorithm to try to get a convex hull from our assortment of
         // interception_points along our plane
 
         int count = interception_points.size();
-        PoolVector<SlicerFace> result;
+        Vector<SlicerFace> result;
 
         if (count < 3) {
             return result;
         }
 
         // First we map from 3D points into a 2D plane represented by the normal we used to cut our mesh
-        Vector3 u = plane_normal.cross(Vector3( 0, 1, 0 )).normalized();
-        if (u == Vector3(0, 0, 0)) {
-            u = plane_normal.cross(Vector3(0, 0, -1)).normalized();
+        int normal_axis = get_normal_axis(plane_normal);
+        const AxisMapping *axis_mapping = NULL;
+        Vector3 u;
+        Vector3 v;
+
+        if (normal_axis >= 0) {
+            axis_mapping = &AXIS_MAPPINGS[normal_axis][plane_normal[normal_axis] > 0 ? 0 : 1];
+        } else {
+            plane_basis(plane_normal, u, v);
         }
-        Vector3 v = u.cross(plane_normal);
 
         // Generate an array of mapped values
         Vector<Mapped2D> mapped;
         mapped.resize(count);
+        Mapped2D *mapped_writer = mapped.ptrw();
+        const Vector3 *points_reader = interception_points.ptr();
 
         // These values will be used to generate new UV coordinates later on
         real_t max_div_x = std::numeric_limits<real_t>::min() ;
@@ -71,8 +124,17 @@ namespace Triangulator {
 
         // Map the 3D vertices into the 2D mapped values
         for (int i = 0; i < count; i++) {
-            Vector3 vert_to_add = interception_points[i];
-            Mapped2D new_mapped_value = Mapped2D(vert_to_add, u, v);
+            Vector3 vert_to_add = points_reader[i];
+            Mapped2D new_mapped_value;
+
+            if (axis_mapping) {
+                new_mapped_value = Mapped2D(vert_to_add, Vector2(
+                    axis_mapping->u_sign * vert_to_add[axis_mapping->u_axis],
+                    axis_mapping->v_sign * vert_to_add[axis_mapping->v_axis]
+                ));
+            } else {
+                new_mapped_value = Mapped2D(vert_to_add, u, v);
+            }
             Vector2 map_val = new_mapped_value.mapped;
 
             // Grab our maximal values so we can map UV's in a proper range
@@ -81,25 +143,26 @@ namespace Triangulator {
             min_div_x = std::min(min_div_x, map_val.x);
             min_div_y = std::min(min_div_y, map_val.y);
 
-            mapped.set(i, new_mapped_value);
+            mapped_writer[i] = new_mapped_value;
         }
 
         // Sort our newly generated array values
         mapped.sort_custom<Mapped2D::Comparator>();
+        const Mapped2D *sorted = mapped.ptr();
 
         // Our final hull mappings will end up in here
-        PoolVector<Mapped2D> hulls;
+        Vector<Mapped2D> hulls;
         hulls.resize(count + 1);
-        PoolVector<Mapped2D>::Write hulls_writer = hulls.write();
+        Mapped2D *hulls_writer = hulls.ptrw();
 
         int k = 0;
 
         // Build the lower hull of the chain
         for (int i = 0; i < count; i++) {
             while (k >= 2) {
-                Vector2 mA = hulls[k - 2].mapped;
-                Vector2 mB = hulls[k - 1].mapped;
-                Vector2 mC = mapped[i].mapped;
+                Vector2 mA = hulls_writer[k - 2].mapped;
+                Vector2 mB = hulls_writer[k - 1].mapped;
+                Vector2 mC = sorted[i].mapped;
 
                 if (tri_area_2d(mA.x, mA.y, mB.x, mB.y, mC.x, mC.y) > 0.0f) {
                     break;
@@ -108,15 +171,15 @@ namespace Triangulator {
                 k--;
             }
 
-            hulls_writer[k++] = mapped[i];
+            hulls_writer[k++] = sorted[i];
         }
 
         // Build the upper hull of the chain
         for (int i = count - 2, t = k + 1; i >= 0; i--) {
             while (k >= t) {
-                Vector2 mA = hulls[k - 2].mapped;
-                Vector2 mB = hulls[k - 1].mapped;
-                Vector2 mC = mapped[i].mapped;
+                Vector2 mA = hulls_writer[k - 2].mapped;
+                Vector2 mB = hulls_writer[k - 1].mapped;
+                Vector2 mC = sorted[i].mapped;
 
                 if (tri_area_2d(mA.x, mA.y, mB.x, mB.y, mC.x, mC.y) > 0.0f) {
                     break;
@@ -125,7 +188,7 @@ namespace Triangulator {
                 k--;
             }
 
-            hulls_writer[k++] = mapped[i];
+            hulls_writer[k++] = sorted[i];
         }
 
         // Finally we can build our mesh. Generate all the variables
@@ -139,7 +202,7 @@ namespace Triangulator {
         }
 
         result.resize(tri_count / 3);
-        PoolVector<SlicerFace>::Write result_writer = result.write();
+        SlicerFace *result_writer = result.ptrw();
 
         float width = max_div_x - min_div_x;
         float height = max_div_y - min_div_y;
@@ -149,9 +212,9 @@ namespace Triangulator {
         // Generate both the vertices and uv's in this loop
         for (int i = 0; i < tri_count; i += 3) {
             // The vertices in our triangle
-            Mapped2D pos_a = hulls[0];
-            Mapped2D pos_b = hulls[index_count];
-            Mapped2D pos_c = hulls[index_count + 1];
+            Mapped2D pos_a = hulls_writer[0];
+            Mapped2D pos_b = hulls_writer[index_count];
+            Mapped2D pos_c = hulls_writer[index_count + 1];
 
             // Generate UV Maps
             Vector2 uv_a = pos_a.mapped;
@@ -169,9 +232,13 @@ namespace Triangulator {
 
             SlicerFace new_face = SlicerFace(pos_a.original, pos_b.original, pos_c.original);
 
-            // TODO - Ezy-Slice support the ability to map these uv values to a specific region
-            // of the texture for atlasing.
-            new_face.set_uvs(uv_a, uv_b, uv_c);
+            // Like Ezy-Slice, map the uv values into a specific region of the texture
+            // so that the cross section can be atlased in with the rest of the mesh
+            new_face.set_uvs(
+                uv_rect.position + uv_a * uv_rect.size,
+                uv_rect.position + uv_b * uv_rect.size,
+                uv_rect.position + uv_c * uv_rect.size
+            );
 
             // The normals is the same for all vertices since the final mesh is completely flat
             new_face.set_normals(plane_normal, plane_normal, plane_normal);
@@ -181,7 +248,6 @@ namespace Triangulator {
 
             index_count++;
         }
-        result_writer.release();
 
         return result;
     }
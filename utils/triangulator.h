@@ -14,9 +14,17 @@ namespace Triangulator {
     real_t tri_area_2d(real_t x1, real_t y1, real_t x2, real_t y2, real_t x3, real_t y3);
 
     /**
-     * Uses a monotone chain algorithm to generate the faces of a convex hull from a set of points
+     * Picks the two directions monotone_chain lays points out along when it flattens them onto
+     * the plane with the given normal. Cross section UVs follow these directions
     */
-    PoolVector<SlicerFace> monotone_chain(const PoolVector<Vector3> &interception_points, Vector3 plane_normal);
+    void plane_basis(const Vector3 &plane_normal, Vector3 &r_u, Vector3 &r_v);
+
+    /**
+     * Uses a monotone chain algorithm to generate the faces of a convex hull from a set of points.
+     * The generated UVs span the hull and are mapped into uv_rect, which allows them to point
+     * at a specific region of a texture atlas
+    */
+    Vector<SlicerFace> monotone_chain(const Vector<Vector3> &interception_points, Vector3 plane_normal, Rect2 uv_rect = Rect2(0, 0, 1, 1));
 } // Triangulator
 
 
@@ -0,0 +1,329 @@
+#include "worker_pool.h"
+#include "core/os/os.h"
+#include "core/safe_refcount.h"
+
+// How many chunks each thread's share of a for_each is cut into. More chunks means a
+// thread that gets stuck with slow tasks holds up less of the rest, at the price of
+// more trips to the queues
+static const int CHUNKS_PER_THREAD = 4;
+
+struct WorkerPool::Completion {
+    Semaphore *semaphore;
+    volatile uint32_t refcount;
+};
+
+struct WorkerPool::Batch {
+    Task task;
+    void *userdata;
+    volatile uint32_t remaining_chunks;
+    Completion *completion;
+};
+
+WorkerPool *WorkerPool::singleton = NULL;
+int (*WorkerPool::lazy_thread_count)() = NULL;
+WorkerPool *WorkerPool::lazy_singleton = NULL;
+Mutex *WorkerPool::lazy_mutex = NULL;
+
+void WorkerPool::set_lazy_singleton(int (*p_thread_count)()) {
+    if (!lazy_mutex) {
+        lazy_mutex = Mutex::create();
+    }
+    lazy_thread_count = p_thread_count;
+}
+
+WorkerPool *WorkerPool::start_lazy_singleton() {
+    MutexLock lock(lazy_mutex);
+
+    // Somebody else may have gotten here first
+    if (!singleton) {
+        if (!lazy_singleton) {
+            lazy_singleton = memnew(WorkerPool(lazy_thread_count()));
+        }
+        singleton = lazy_singleton;
+    }
+
+    return singleton;
+}
+
+void WorkerPool::free_lazy_singleton() {
+    if (singleton == lazy_singleton) {
+        singleton = NULL;
+    }
+
+    if (lazy_singleton) {
+        memdelete(lazy_singleton);
+        lazy_singleton = NULL;
+    }
+
+    lazy_thread_count = NULL;
+    if (lazy_mutex) {
+        memdelete(lazy_mutex);
+        lazy_mutex = NULL;
+    }
+}
+
+void WorkerPool::worker_main(void *p_worker) {
+    Worker *worker = (Worker *)p_worker;
+    WorkerPool *pool = worker->pool;
+
+    while (true) {
+        Chunk chunk;
+        if (pool->take_chunk(worker->index, chunk)) {
+            pool->run_chunk(chunk);
+            continue;
+        }
+
+        if (pool->exiting) {
+            return;
+        }
+
+        pool->work_available->wait();
+    }
+}
+
+int WorkerPool::get_current_worker() const {
+    Thread::ID caller = Thread::get_caller_id();
+    for (int i = 0; i < workers.size(); i++) {
+        if (workers[i]->thread_id == caller) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void WorkerPool::push_chunk(int current, const Chunk &chunk) {
+    Worker *target = workers[current != -1 ? current : atomic_increment(&next_queue) % workers.size()];
+    target->mutex->lock();
+    target->chunks.push_back(chunk);
+    target->mutex->unlock();
+}
+
+bool WorkerPool::take_chunk(int worker, Chunk &r_chunk) {
+    if (worker != -1) {
+        Worker *own = workers[worker];
+        own->mutex->lock();
+        int size = own->chunks.size();
+        if (size > own->head) {
+            r_chunk = own->chunks[size - 1];
+            if (size - 1 == own->head) {
+                own->chunks.clear();
+                own->head = 0;
+            } else {
+                own->chunks.resize(size - 1);
+            }
+            own->mutex->unlock();
+            return true;
+        }
+        own->mutex->unlock();
+    }
+
+    // Starting from the next worker along spreads the thieves out over the queues,
+    // instead of them all piling onto the first
+    int count = workers.size();
+    for (int i = 1; i <= count; i++) {
+        int victim_idx = (worker + i + count) % count;
+        if (victim_idx == worker) {
+            continue;
+        }
+
+        Worker *victim = workers[victim_idx];
+        victim->mutex->lock();
+        if (victim->chunks.size() > victim->head) {
+            r_chunk = victim->chunks[victim->head++];
+            if (victim->head == victim->chunks.size()) {
+                victim->chunks.clear();
+                victim->head = 0;
+            }
+            victim->mutex->unlock();
+
+            atomic_increment(&steals);
+            return true;
+        }
+        victim->mutex->unlock();
+    }
+
+    return false;
+}
+
+void WorkerPool::run_chunk(const Chunk &chunk) {
+    uint64_t start = OS::get_singleton()->get_ticks_usec();
+
+    Batch *batch = chunk.batch;
+    for (int i = chunk.begin; i < chunk.end; i++) {
+        batch->task(batch->userdata, i);
+    }
+
+    atomic_add(&tasks, (uint64_t)(chunk.end - chunk.begin));
+    atomic_add(&busy_usec, OS::get_singleton()->get_ticks_usec() - start);
+
+    // Whoever handed the batch over frees it in finish_batch as soon as they wake up,
+    // so nothing in it can be touched after the post
+    if (atomic_decrement(&batch->remaining_chunks) == 0) {
+        Completion *completion = batch->completion;
+        completion->semaphore->post();
+        release_completion(completion);
+    }
+}
+
+void WorkerPool::release_completion(Completion *completion) {
+    if (atomic_decrement(&completion->refcount) == 0) {
+        memdelete(completion->semaphore);
+        memdelete(completion);
+    }
+}
+
+WorkerPool::Batch *WorkerPool::begin_batch(Task task, void *userdata, int chunk_count) {
+    atomic_increment(&batches);
+
+    Batch *batch = memnew(Batch);
+    batch->task = task;
+    batch->userdata = userdata;
+    batch->remaining_chunks = chunk_count;
+    batch->completion = memnew(Completion);
+    batch->completion->semaphore = Semaphore::create();
+    batch->completion->refcount = 2;
+
+    // Nothing's ever going to be queued, so nobody else would post
+    if (chunk_count == 0) {
+        batch->completion->semaphore->post();
+        release_completion(batch->completion);
+    }
+
+    return batch;
+}
+
+void WorkerPool::queue_chunk(Batch *batch, int begin, int end) {
+    Chunk chunk;
+    chunk.batch = batch;
+    chunk.begin = begin;
+    chunk.end = end;
+
+    if (workers.size() == 0) {
+        run_chunk(chunk);
+        return;
+    }
+
+    push_chunk(get_current_worker(), chunk);
+    work_available->post();
+}
+
+void WorkerPool::finish_batch(Batch *batch) {
+    // Whatever's left of our chunks is either sitting in a queue, which we can help with,
+    // or already being run by somebody else, in which case all we can do is wait
+    int current = get_current_worker();
+    while (batch->remaining_chunks > 0) {
+        Chunk chunk;
+        if (!take_chunk(current, chunk)) {
+            break;
+        }
+        run_chunk(chunk);
+    }
+
+    // Whoever finishes the last chunk posts exactly once, so this never waits on a chunk
+    // that's already done
+    Completion *completion = batch->completion;
+    completion->semaphore->wait();
+    release_completion(completion);
+    memdelete(batch);
+}
+
+void WorkerPool::for_each(int count, Task task, void *userdata) {
+    if (count <= 0) {
+        return;
+    }
+
+    int chunk_count = MIN(count, (workers.size() + 1) * CHUNKS_PER_THREAD);
+    if (workers.size() == 0) {
+        chunk_count = 1;
+    }
+
+    Batch *batch = begin_batch(task, userdata, chunk_count);
+
+    // Work handed over from inside a task goes onto the worker's own queue, where it'll
+    // most likely be picked straight back up by the same thread. Anything else is dealt
+    // out over all of the queues
+    int current = get_current_worker();
+    for (int i = 0; i < chunk_count; i++) {
+        Chunk chunk;
+        chunk.batch = batch;
+        chunk.begin = (int)((int64_t)count * i / chunk_count);
+        chunk.end = (int)((int64_t)count * (i + 1) / chunk_count);
+
+        if (workers.size() == 0) {
+            run_chunk(chunk);
+        } else {
+            push_chunk(current, chunk);
+        }
+    }
+
+    for (int i = 0; i < MIN(chunk_count, workers.size()); i++) {
+        work_available->post();
+    }
+
+    finish_batch(batch);
+}
+
+WorkerPool::Stats WorkerPool::get_stats() const {
+    Stats stats;
+    stats.thread_count = workers.size();
+    stats.batches = batches;
+    stats.tasks = tasks;
+    stats.steals = steals;
+    stats.busy_usec = busy_usec;
+    stats.elapsed_usec = OS::get_singleton()->get_ticks_usec() - stats_start_usec;
+    return stats;
+}
+
+void WorkerPool::reset_stats() {
+    batches = 0;
+    tasks = 0;
+    steals = 0;
+    busy_usec = 0;
+    stats_start_usec = OS::get_singleton()->get_ticks_usec();
+}
+
+WorkerPool::WorkerPool(int thread_count) {
+    exiting = 0;
+    next_queue = 0;
+    work_available = Semaphore::create();
+    reset_stats();
+
+    for (int i = 0; i < thread_count; i++) {
+        Worker *worker = memnew(Worker);
+        worker->pool = this;
+        worker->index = i;
+        worker->thread = NULL;
+        worker->thread_id = 0;
+        worker->mutex = Mutex::create();
+        worker->head = 0;
+        workers.push_back(worker);
+    }
+
+    // Every worker has to exist before any of them start looking through the others' queues
+    for (int i = 0; i < workers.size(); i++) {
+        workers[i]->thread = Thread::create(worker_main, workers[i]);
+        workers[i]->thread_id = workers[i]->thread->get_id();
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    exiting = 1;
+    for (int i = 0; i < workers.size(); i++) {
+        work_available->post();
+    }
+
+    // Workers look through each other's queues on their way out, so
+    // nothing can be freed until they've all stopped
+    for (int i = 0; i < workers.size(); i++) {
+        Thread::wait_to_finish(workers[i]->thread);
+    }
+
+    for (int i = 0; i < workers.size(); i++) {
+        memdelete(workers[i]->thread);
+        memdelete(workers[i]->mutex);
+        memdelete(workers[i]);
+    }
+
+    memdelete(work_available);
+}
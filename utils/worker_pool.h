@@ -0,0 +1,179 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/vector.h"
+
+/**
+ * A set of long lived threads that the slicer hands its parallel work off to, rather
+ * than starting up new threads for every cut. Each worker keeps its own queue of work,
+ * taking from the back of it and, once that runs dry, stealing from the front of the
+ * others'. Every queue has its own lock, so callers on different threads only ever
+ * contend over the queue they happen to be touching rather than all over a single one.
+ *
+ * Whoever hands work over pitches in with it (along with anything else that's queued)
+ * until their own work is done, so work can be handed over from inside other work
+ * without the pool running out of threads
+*/
+class WorkerPool {
+public:
+    typedef void (*Task)(void *userdata, int idx);
+
+    /**
+     * Running totals, since the pool was started or the stats were last reset
+    */
+    struct Stats {
+        int thread_count;
+        // Calls to for_each
+        uint64_t batches;
+        // Individual indexes run
+        uint64_t tasks;
+        // Chunks of indexes that were taken from somebody else's queue
+        uint64_t steals;
+        // Time spent running tasks, summed over every thread that ran them
+        uint64_t busy_usec;
+        uint64_t elapsed_usec;
+    };
+
+    /**
+     * Everything handed over by one call to for_each (or begin_batch)
+    */
+    struct Batch;
+
+private:
+    /**
+     * Lets whoever handed a batch over sleep until its last chunk is done. Whoever
+     * finishes that chunk can still be on their way out of post when the wait returns,
+     * so this lives on the heap, and is freed by whichever of the two is done with it last
+    */
+    struct Completion;
+
+    /**
+     * A run of a batch's indexes that gets handed out as a whole
+    */
+    struct Chunk {
+        Batch *batch;
+        int begin;
+        int end;
+    };
+
+    struct Worker {
+        WorkerPool *pool;
+        int index;
+        Thread *thread;
+        Thread::ID thread_id;
+
+        Mutex *mutex;
+        // Chunks before head have already been stolen. They're only cleared out once
+        // the queue empties, so stealing never has to shuffle the rest forward
+        Vector<Chunk> chunks;
+        int head;
+    };
+
+    Vector<Worker *> workers;
+
+    // Posted once for every chunk queued, so that sleeping workers know to go looking
+    Semaphore *work_available;
+    volatile uint32_t exiting;
+
+    // Where callers that aren't workers put their next chunk, so that they're spread out
+    volatile uint32_t next_queue;
+
+    volatile uint64_t batches;
+    volatile uint64_t tasks;
+    volatile uint64_t steals;
+    volatile uint64_t busy_usec;
+    uint64_t stats_start_usec;
+
+    static WorkerPool *singleton;
+
+    // Used to start up the shared pool the first time it's asked for, see set_lazy_singleton
+    static int (*lazy_thread_count)();
+    static WorkerPool *lazy_singleton;
+    static Mutex *lazy_mutex;
+
+    static WorkerPool *start_lazy_singleton();
+
+    static void worker_main(void *p_worker);
+
+    /**
+     * The worker running on the calling thread, or -1 if it isn't one of ours
+    */
+    int get_current_worker() const;
+
+    /**
+     * Puts the chunk on the calling worker's queue, or if the caller isn't a worker, on
+     * the next queue along
+    */
+    void push_chunk(int current, const Chunk &chunk);
+
+    /**
+     * Takes a chunk from the back of the worker's own queue (when worker isn't -1),
+     * and otherwise from the front of whichever queue has one
+    */
+    bool take_chunk(int worker, Chunk &r_chunk);
+
+    void run_chunk(const Chunk &chunk);
+
+    static void release_completion(Completion *completion);
+
+public:
+    /**
+     * The pool shared by the whole module. If there isn't one yet and set_lazy_singleton has
+     * been called, one is started up now. Pass false for p_start to only look at the pool
+     * if it's already running
+    */
+    static WorkerPool *get_singleton(bool p_start = true) {
+        if (singleton || !p_start || !lazy_thread_count) {
+            return singleton;
+        }
+        return start_lazy_singleton();
+    }
+    static void set_singleton(WorkerPool *p_singleton) {
+        singleton = p_singleton;
+    }
+
+    /**
+     * Has get_singleton start up a pool the first time it's needed, so that nothing that never
+     * hands over any work ends up with threads sitting around. The number of threads is asked
+     * for at that point rather than now
+    */
+    static void set_lazy_singleton(int (*p_thread_count)());
+
+    /**
+     * Stops the pool set_lazy_singleton started, if it ever did
+    */
+    static void free_lazy_singleton();
+
+    /**
+     * Calls task once for every index from 0 up to count and returns once they've all
+     * finished. The calling thread runs tasks too, so it's safe to call from a task
+    */
+    void for_each(int count, Task task, void *userdata);
+
+    /**
+     * For work that can't all be handed over up front, such as a TaskGraph's. The batch is
+     * done once chunk_count chunks of it have been queued (from any thread) with queue_chunk
+     * and have run. finish_batch helps out until then and frees the batch
+    */
+    Batch *begin_batch(Task task, void *userdata, int chunk_count);
+    void queue_chunk(Batch *batch, int begin, int end);
+    void finish_batch(Batch *batch);
+
+    int get_thread_count() const {
+        return workers.size();
+    }
+
+    Stats get_stats() const;
+    void reset_stats();
+
+    /**
+     * Starts up thread_count workers. Zero leaves every task to the calling thread
+    */
+    WorkerPool(int thread_count);
+    ~WorkerPool();
+};
+
+#endif // WORKER_POOL_H